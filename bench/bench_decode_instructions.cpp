@@ -0,0 +1,79 @@
+#include <iomanip>
+#include <iostream>
+
+#include <x86.hpp>
+
+#include "bench_util.hpp"
+
+// Repeats an ELF file's .text until it reaches the requested size, then decodes the
+// corpus one parse_x86_instruction call at a time, one decode_compact_instruction
+// call at a time, and in decode_instructions batches.
+//
+//   bench_decode_instructions [elf file] [corpus MB]
+
+int main( int argc, char** argv ) {
+	std::string file_name = argc > 1 ? argv[ 1 ] : "../test/main";
+	std::size_t corpus_mb = argc > 2 ? std::stoull( argv[ 2 ] ) : 16;
+
+	auto elf = stig::parse_elf( file_name );
+	if ( !elf ) {
+		std::cerr << elf.error() << "\n";
+		return 1;
+	}
+	std::vector<uint8_t> text;
+	for ( const auto& func : elf->text ) {
+		for ( const auto& instruction : func.instructions ) {
+			text.insert( text.end(), instruction.machine_bytes.begin(), instruction.machine_bytes.end() );
+		}
+	}
+	std::vector<uint8_t> corpus;
+	while ( !text.empty() && corpus.size() < corpus_mb << 20 ) {
+		corpus.insert( corpus.end(), text.begin(), text.end() );
+	}
+
+	std::size_t instruction_count = 0;
+	double instruction_seconds = time_runs( 3, [ & ]() {
+		instruction_count = 0;
+		for ( std::size_t pos = 0; pos < corpus.size(); ) {
+			auto instruction = stig::parse_x86_instruction( std::span( corpus ).subspan( pos ), pos );
+			if ( !instruction ) {
+				break;
+			}
+			pos += instruction->machine_bytes.size();
+			++instruction_count;
+		}
+	} );
+	std::size_t compact_count = 0;
+	double compact_seconds = time_runs( 3, [ & ]() {
+		compact_count = 0;
+		for ( std::size_t pos = 0; pos < corpus.size(); ) {
+			auto instruction = stig::decode_compact_instruction( std::span( corpus ).subspan( pos ), pos );
+			if ( !instruction ) {
+				break;
+			}
+			pos += instruction->byte_count;
+			++compact_count;
+		}
+	} );
+	std::vector<stig::x86_compact_instruction> buffer( 4096 );
+	std::size_t batch_count = 0;
+	double batch_seconds = time_runs( 3, [ & ]() {
+		batch_count = 0;
+		for ( std::size_t pos = 0; pos < corpus.size(); ) {
+			auto result = stig::decode_instructions( std::span( corpus ).subspan( pos ), pos, buffer );
+			pos += result.consumed;
+			batch_count += result.count;
+			if ( result.error != stig::decode_error::none ) {
+				break;
+			}
+		}
+	} );
+
+	double megabytes = static_cast<double>( corpus.size() ) / ( 1 << 20 );
+	std::cout << corpus.size() << " bytes, " << batch_count << " instructions\n" << std::fixed << std::setprecision( 1 )
+			  << "parse_x86_instruction:      " << megabytes / instruction_seconds << " MB/sec (" << instruction_count << ")\n"
+			  << "decode_compact_instruction: " << megabytes / compact_seconds << " MB/sec (" << compact_count << ")\n"
+			  << "decode_instructions:        " << megabytes / batch_seconds << " MB/sec, "
+			  << instruction_seconds / batch_seconds << "x\n";
+	return 0;
+}
@@ -0,0 +1,59 @@
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <regex>
+
+#include <x86.hpp>
+
+// Replicates an objdump file into a large in-memory corpus and compares the
+// std::regex header search extract_function_names used to run on every line
+// with match_function_header.
+//
+//   bench_extract_function_names [disasm file] [corpus MB]
+
+template<typename Match>
+void run( const std::string& label, std::string_view text, Match match ) {
+	std::size_t names = 0;
+	std::size_t lines = 0;
+	auto start = std::chrono::steady_clock::now();
+	std::size_t pos = 0;
+	while ( pos < text.size() ) {
+		names += match( stig::next_line_view( text, pos ) );
+		++lines;
+	}
+	std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+	std::cout << std::left << std::setw( 24 ) << label
+			  << names << " names, " << std::fixed << std::setprecision( 3 ) << elapsed.count() << " s, "
+			  << std::setprecision( 0 ) << lines / elapsed.count() << " lines/sec, "
+			  << std::setprecision( 1 ) << ( text.size() >> 20 ) / elapsed.count() << " MB/s\n";
+}
+
+int main( int argc, char** argv ) {
+	std::string file_name = argc > 1 ? argv[ 1 ] : "../test/main_disasm.txt";
+	std::size_t corpus_mb = argc > 2 ? std::stoull( argv[ 2 ] ) : 64;
+
+	std::ifstream file( file_name, std::ios::binary );
+	if ( !file ) {
+		std::cerr << "Failed to Open File: " << file_name << "\n";
+		return 1;
+	}
+	std::string text( ( std::istreambuf_iterator<char>( file ) ), std::istreambuf_iterator<char>() );
+	if ( !text.ends_with( '\n' ) ) {
+		text += '\n';
+	}
+	std::string corpus;
+	corpus.reserve( ( corpus_mb << 20 ) + text.size() );
+	while ( corpus.size() < corpus_mb << 20 ) {
+		corpus += text;
+	}
+
+	std::regex func_name_regex( R"(^[0-9A-Fa-f]{16}\s+<([^>]+)>)" );
+	run( "std::regex_search", corpus, [ & ]( std::string_view line ) {
+		std::cmatch match;
+		return std::regex_search( line.data(), line.data() + line.size(), match, func_name_regex );
+	} );
+	run( "match_function_header", corpus, []( std::string_view line ) {
+		return stig::match_function_header( line ).has_value();
+	} );
+	return 0;
+}
@@ -0,0 +1,67 @@
+#include <cstdio>
+#include <iomanip>
+#include <iostream>
+
+#include <x86.hpp>
+
+#include "bench_util.hpp"
+
+// Repeats an objdump file until it reaches the requested size, then counts every
+// call instruction both by walking the parsed functions and by scanning the
+// mnemonic column of an instruction_store.
+//
+//   bench_instruction_store [disasm file] [corpus MB]
+
+int main( int argc, char** argv ) {
+	std::string file_name = argc > 1 ? argv[ 1 ] : "../test/main_disasm.txt";
+	std::size_t corpus_mb = argc > 2 ? std::stoull( argv[ 2 ] ) : 64;
+
+	std::ifstream file( file_name, std::ios::binary );
+	if ( !file ) {
+		std::cerr << "Failed to Open File: " << file_name << "\n";
+		return 1;
+	}
+	std::string text( ( std::istreambuf_iterator<char>( file ) ), std::istreambuf_iterator<char>() );
+	if ( !text.ends_with( '\n' ) ) {
+		text += '\n';
+	}
+	text += '\n';
+
+	std::string corpus_name = "bench_instruction_store_corpus.txt";
+	{
+		std::ofstream corpus( corpus_name, std::ios::binary );
+		for ( std::size_t written = 0; written < corpus_mb << 20; written += text.size() ) {
+			corpus << text;
+		}
+	}
+	auto elf = stig::parse_disassembly( corpus_name );
+	auto store = stig::parse_instruction_store( corpus_name );
+	std::remove( corpus_name.c_str() );
+	if ( !elf || !store ) {
+		std::cerr << ( elf ? store.error() : elf.error() ) << "\n";
+		return 1;
+	}
+
+	std::size_t functions_count = 0;
+	double functions_seconds = time_runs( 10, [ & ]() {
+		functions_count = 0;
+		for ( auto section : { stig::elf_section::init, stig::elf_section::plt, stig::elf_section::plt_got, stig::elf_section::text, stig::elf_section::fini } ) {
+			for ( const auto& func : *elf->functions( section ) ) {
+				for ( const auto& instruction : func.instructions ) {
+					functions_count += instruction.mnemonic == stig::x86_mnemonic::call;
+				}
+			}
+		}
+	} );
+	std::size_t store_count = 0;
+	double store_seconds = time_runs( 10, [ & ]() {
+		store_count = store->count( stig::x86_mnemonic::call );
+	} );
+
+	double instructions = static_cast<double>( store->size() );
+	std::cout << store->size() << " instructions, " << store_count << " calls\n" << std::fixed << std::setprecision( 1 )
+			  << "functions: " << instructions / functions_seconds / 1e6 << "M instructions/sec (" << functions_count << " calls)\n"
+			  << "store:     " << instructions / store_seconds / 1e6 << "M instructions/sec, "
+			  << functions_seconds / store_seconds << "x\n";
+	return 0;
+}
@@ -0,0 +1,106 @@
+#include <iomanip>
+#include <iostream>
+
+#include <x86.hpp>
+
+#include "bench_util.hpp"
+
+// Runs a counting loop (add, cmp, jne) through the unordered_map program the VM used
+// to step, one hash lookup per instruction, through a dispatch table whose steps all
+// call their handlers, stepping through its micro-ops, through x86_vm::load_program's
+// chained basic blocks, and through blocks compiled to host code once they are hot.
+//
+//   bench_load_program [iterations]
+
+int main( int argc, char** argv ) {
+	int64_t iterations = argc > 1 ? std::stoll( argv[ 1 ] ) : 1000000;
+
+	stig::function func;
+	func.name = "count";
+	func.instructions.push_back( { 0, std::vector<uint8_t>{ 0x48, 0x83, 0xc0, 0x01 }, stig::x86_mnemonic::add,
+								   std::vector<stig::x86_operand>{ stig::x86_immediate{ 1 }, stig::x86_register::rax } } );
+	func.instructions.push_back( { 4, std::vector<uint8_t>{ 0x48, 0x39, 0xd0 }, stig::x86_mnemonic::cmp,
+								   std::vector<stig::x86_operand>{ stig::x86_register::rdx, stig::x86_register::rax } } );
+	func.instructions.push_back( { 7, std::vector<uint8_t>{ 0x75, 0xf7 }, stig::x86_mnemonic::jne,
+								   std::vector<stig::x86_operand>{ stig::x86_address{ 0 } } } );
+	auto prog = stig::convert_to_program( func );
+	if ( !prog ) {
+		std::cerr << prog.error() << "\n";
+		return 1;
+	}
+	prog->exit_point = 9;
+
+	stig::x86_vm hashed{};
+	double hashed_seconds = time_runs( 3, [ & ]() {
+		hashed.cpu.rax = 0;
+		hashed.cpu.rdx = iterations;
+		hashed.cpu.rip = prog->entry_point;
+		while ( static_cast<uint64_t>( hashed.cpu.rip ) != prog->exit_point ) {
+			auto& instruction = prog->instrs.at( hashed.cpu.rip );
+			if ( !hashed.execute_instruction( instruction ) ) {
+				break;
+			}
+			if ( instruction.mnemonic != stig::x86_mnemonic::jne ) {
+				hashed.cpu.rip += instruction.machine_bytes.size();
+			}
+		}
+	} );
+	auto table = stig::lower_program( prog.value() );
+	if ( !table ) {
+		std::cerr << table.error() << "\n";
+		return 1;
+	}
+	for ( auto& step : table->steps ) {
+		step.op = stig::micro_op{};
+	}
+	stig::x86_vm handled{};
+	double handled_seconds = time_runs( 3, [ & ]() {
+		handled.cpu.rax = 0;
+		handled.cpu.rdx = iterations;
+		handled.run( table.value(), prog->entry_point, prog->exit_point );
+	} );
+	auto micro_table = stig::lower_program( prog.value() );
+	stig::x86_vm stepped{};
+	double stepped_seconds = time_runs( 3, [ & ]() {
+		stepped.cpu.rax = 0;
+		stepped.cpu.rdx = iterations;
+		stepped.run( micro_table.value(), prog->entry_point, prog->exit_point );
+	} );
+	stig::x86_vm dispatched{};
+	std::expected<uint32_t,std::string> result;
+	double dispatched_seconds = time_runs( 3, [ & ]() {
+		dispatched.cpu.rax = 0;
+		dispatched.cpu.rdx = iterations;
+		result = dispatched.load_program( prog.value() );
+	} );
+	if ( !result ) {
+		std::cerr << result.error() << "\n";
+		return 1;
+	}
+	auto jit_table = stig::lower_program( prog.value() );
+	stig::x86_vm compiled{};
+	double compiled_seconds = time_runs( 3, [ & ]() {
+		stig::block_cache cache{ &jit_table.value(), prog->exit_point };
+		cache.jit_threshold = 16;
+		compiled.cpu.rax = 0;
+		compiled.cpu.rdx = iterations;
+		result = compiled.run( cache, prog->entry_point );
+	} );
+	if ( !result || compiled.cpu.rax != iterations ) {
+		std::cerr << ( result ? "jit result differs" : result.error() ) << "\n";
+		return 1;
+	}
+
+	double millions = static_cast<double>( iterations * 3 ) / 1e6;
+	std::cout << iterations * 3 << " instructions\n" << std::fixed << std::setprecision( 1 )
+			  << "unordered_map:  " << millions / hashed_seconds << " M instructions/sec\n"
+			  << "handlers:       " << millions / handled_seconds << " M instructions/sec, "
+			  << hashed_seconds / handled_seconds << "x\n"
+			  << "micro-ops:      " << millions / stepped_seconds << " M instructions/sec, "
+			  << hashed_seconds / stepped_seconds << "x\n"
+			  << "blocks:         " << millions / dispatched_seconds << " M instructions/sec, "
+			  << hashed_seconds / dispatched_seconds << "x\n"
+			  << "jit:            " << millions / compiled_seconds << " M instructions/sec, "
+			  << hashed_seconds / compiled_seconds << "x\n";
+	return 0;
+}
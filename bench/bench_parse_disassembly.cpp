@@ -0,0 +1,78 @@
+#include <chrono>
+#include <cstdio>
+#include <iomanip>
+#include <iostream>
+
+#include <x86.hpp>
+
+// Writes a copy of an objdump file repeated until it reaches the requested size
+// and times parse_disassembly on it with an increasing number of threads, then
+// single threaded into a monotonic arena (parse plus teardown, against the heap).
+//
+//   bench_parse_disassembly [disasm file] [corpus MB]
+
+int main( int argc, char** argv ) {
+	std::string file_name = argc > 1 ? argv[ 1 ] : "../test/main_disasm.txt";
+	std::size_t corpus_mb = argc > 2 ? std::stoull( argv[ 2 ] ) : 256;
+
+	std::ifstream file( file_name, std::ios::binary );
+	if ( !file ) {
+		std::cerr << "Failed to Open File: " << file_name << "\n";
+		return 1;
+	}
+	std::string text( ( std::istreambuf_iterator<char>( file ) ), std::istreambuf_iterator<char>() );
+	if ( !text.ends_with( '\n' ) ) {
+		text += '\n';
+	}
+	text += '\n';
+
+	std::string corpus_name = "bench_parse_disassembly_corpus.txt";
+	{
+		std::ofstream corpus( corpus_name, std::ios::binary );
+		for ( std::size_t written = 0; written < corpus_mb << 20; written += text.size() ) {
+			corpus << text;
+		}
+	}
+	auto corpus_file = stig::map_file( corpus_name );
+	if ( !corpus_file ) {
+		std::cerr << corpus_file.error() << "\n";
+		return 1;
+	}
+
+	std::size_t max_threads = std::max( 1u, std::thread::hardware_concurrency() );
+	double serial_seconds = 0;
+	for ( std::size_t threads = 1; threads <= max_threads; threads *= 2 ) {
+		auto start = std::chrono::steady_clock::now();
+		auto res = stig::parse_disassembly( corpus_file.value(), threads );
+		std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+		if ( !res ) {
+			std::cerr << res.error() << "\n";
+			return 1;
+		}
+		if ( threads == 1 ) {
+			serial_seconds = elapsed.count();
+		}
+		std::cout << std::setw( 3 ) << threads << " threads: " << std::fixed << std::setprecision( 3 ) << elapsed.count() << " s, "
+				  << std::setprecision( 1 ) << ( corpus_file->size >> 20 ) / elapsed.count() << " MB/s, "
+				  << serial_seconds / elapsed.count() << "x\n";
+	}
+	auto time_parse = [ & ]( bool use_arena ) {
+		auto start = std::chrono::steady_clock::now();
+		{
+			std::pmr::monotonic_buffer_resource arena;
+			auto* resource = use_arena ? &arena : std::pmr::get_default_resource();
+			auto res = stig::parse_disassembly( corpus_file.value(), 1, resource );
+			if ( !res ) {
+				std::cerr << res.error() << "\n";
+			}
+		}
+		std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+		return elapsed.count();
+	};
+	double heap_seconds = time_parse( false );
+	double arena_seconds = time_parse( true );
+	std::cout << "heap:  " << std::fixed << std::setprecision( 3 ) << heap_seconds << " s\n"
+			  << "arena: " << arena_seconds << " s, " << std::setprecision( 1 ) << heap_seconds / arena_seconds << "x\n";
+	std::remove( corpus_name.c_str() );
+	return 0;
+}
@@ -0,0 +1,61 @@
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+
+#include <x86.hpp>
+
+// Replicates the instruction lines of an objdump file into a large in-memory
+// corpus and reports lines/sec for parse_x86_instruction and parse_x86_instruction_view.
+//
+//   bench_parse_x86_instruction [disasm file] [corpus lines]
+
+template<typename Parse>
+void run( const std::string& label, const std::vector<std::string>& corpus, Parse parse ) {
+	std::size_t failures = 0;
+	auto start = std::chrono::steady_clock::now();
+	for ( auto& line : corpus ) {
+		if ( !parse( line ) ) {
+			++failures;
+		}
+	}
+	std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+	std::cout << std::left << std::setw( 30 ) << label
+			  << corpus.size() << " lines in " << std::fixed << std::setprecision( 3 ) << elapsed.count() << " s, "
+			  << std::setprecision( 0 ) << corpus.size() / elapsed.count() << " lines/sec"
+			  << " (" << failures << " unparsed)\n";
+}
+
+int main( int argc, char** argv ) {
+	std::string file_name = argc > 1 ? argv[ 1 ] : "../test/main_disasm.txt";
+	std::size_t corpus_lines = argc > 2 ? std::stoull( argv[ 2 ] ) : 4'000'000;
+
+	std::ifstream file( file_name );
+	if ( !file ) {
+		std::cerr << "Failed to Open File: " << file_name << "\n";
+		return 1;
+	}
+	std::vector<std::string> lines;
+	std::string line;
+	while ( std::getline( file, line ) ) {
+		if ( line.find( ":\t" ) != std::string::npos ) {
+			lines.push_back( line.substr( line.find_first_not_of( ' ' ) ) );
+		}
+	}
+	if ( lines.empty() ) {
+		std::cerr << "No Instruction Lines found in " << file_name << "\n";
+		return 1;
+	}
+	std::vector<std::string> corpus;
+	corpus.reserve( corpus_lines );
+	for ( std::size_t i = 0; i < corpus_lines; ++i ) {
+		corpus.push_back( lines[ i % lines.size() ] );
+	}
+
+	run( "parse_x86_instruction", corpus, []( const std::string& l ) {
+		return stig::parse_x86_instruction( l ).has_value();
+	} );
+	run( "parse_x86_instruction_view", corpus, []( const std::string& l ) {
+		return stig::parse_x86_instruction_view( l ).has_value();
+	} );
+	return 0;
+}
@@ -0,0 +1,58 @@
+#include <iomanip>
+#include <iostream>
+#include <random>
+
+#include <x86.hpp>
+
+#include "bench_util.hpp"
+
+// Symbolizes random addresses across an ELF file's code sections, once through
+// find_function on the parsed functions and once through a symbol_index.
+//
+//   bench_symbol_index [elf file] [lookups]
+
+int main( int argc, char** argv ) {
+	std::string file_name = argc > 1 ? argv[ 1 ] : "../test/main";
+	std::size_t lookups = argc > 2 ? std::stoull( argv[ 2 ] ) : 1 << 22;
+
+	auto elf = stig::open_elf_file( file_name );
+	if ( !elf ) {
+		std::cerr << elf.error() << "\n";
+		return 1;
+	}
+	auto parsed = stig::parse_elf( elf.value() );
+	if ( !parsed ) {
+		std::cerr << parsed.error() << "\n";
+		return 1;
+	}
+	auto index = stig::build_symbol_index( elf.value() );
+
+	std::mt19937_64 random( 42 );
+	std::uniform_int_distribution<uint64_t> distribution( parsed->range( stig::elf_section::init )->begin, parsed->range( stig::elf_section::fini )->end - 1 );
+	std::vector<uint64_t> addresses( lookups );
+	for ( auto& address : addresses ) {
+		address = distribution( random );
+	}
+
+	std::size_t function_hits = 0;
+	double function_seconds = time_runs( 3, [ & ]() {
+		function_hits = 0;
+		for ( auto address : addresses ) {
+			function_hits += stig::find_function( parsed.value(), address ) != nullptr;
+		}
+	} );
+	std::size_t index_hits = 0;
+	double index_seconds = time_runs( 3, [ & ]() {
+		index_hits = 0;
+		for ( auto address : addresses ) {
+			index_hits += index.containing( address ).has_value();
+		}
+	} );
+
+	double millions = static_cast<double>( lookups ) / 1e6;
+	std::cout << index.size() << " symbols, " << lookups << " lookups\n" << std::fixed << std::setprecision( 1 )
+			  << "find_function:           " << millions / function_seconds << " M/sec (" << function_hits << ")\n"
+			  << "symbol_index::containing: " << millions / index_seconds << " M/sec (" << index_hits << "), "
+			  << function_seconds / index_seconds << "x\n";
+	return 0;
+}
@@ -0,0 +1,14 @@
+#pragma once
+
+#include <chrono>
+
+// Mean wall-clock seconds per call of f over runs calls.
+template<typename F>
+double time_runs( int runs, F&& f ) {
+	auto start = std::chrono::steady_clock::now();
+	for ( int i = 0; i < runs; ++i ) {
+		f();
+	}
+	std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+	return elapsed.count() / runs;
+}
@@ -1,7 +1,132 @@
 #include <x86.hpp>
 
+#include <fcntl.h>
+#if defined( __AVX2__ ) || defined( __SSE2__ )
+#include <immintrin.h>
+#endif
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
 namespace stig {
 
+	// =================
+    //  Next Token View
+    // =================
+
+	bool is_space( char c ) {
+		return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\v' || c == '\f';
+	}
+
+	std::string_view next_token_view( std::string_view buffer, std::size_t& pos ) {
+		while ( pos < buffer.size() && is_space( buffer[ pos ] ) ) {
+			++pos;
+		}
+		std::size_t start = pos;
+		while ( pos < buffer.size() && !is_space( buffer[ pos ] ) ) {
+			++pos;
+		}
+		return buffer.substr( start, pos - start );
+	}
+
+	// =================
+    //  Hex Digit Table
+    // =================
+
+	constexpr std::array<int8_t,256> hex_digit_table = []() {
+		std::array<int8_t,256> table{};
+		table.fill( -1 );
+		for ( int i = 0; i < 10; ++i ) {
+			table[ '0' + i ] = static_cast<int8_t>( i );
+		}
+		for ( int i = 0; i < 6; ++i ) {
+			table[ 'a' + i ] = static_cast<int8_t>( 10 + i );
+			table[ 'A' + i ] = static_cast<int8_t>( 10 + i );
+		}
+		return table;
+	}();
+
+	// Decodes a 1 or 2 digit hex token without building a string.
+	std::optional<uint8_t> decode_hex_byte( std::string_view token ) {
+		if ( token.empty() || token.size() > 2 ) {
+			return std::nullopt;
+		}
+		int value = 0;
+		for ( char c : token ) {
+			int digit = hex_digit_table[ static_cast<uint8_t>( c ) ];
+			if ( digit < 0 ) {
+				return std::nullopt;
+			}
+			value = ( value << 4 ) | digit;
+		}
+		return static_cast<uint8_t>( value );
+	}
+
+	// ===============
+    //  Match Mask 64
+    // ===============
+
+	// Bit i of the result is set when p[ i ] == c, for the first n <= 64 bytes at p.
+	uint64_t match_mask64( const char* p, std::size_t n, char c ) {
+		alignas( 64 ) char block[ 64 ];
+		if ( n < 64 ) {
+			std::memset( block, 0, sizeof( block ) );
+			std::memcpy( block, p, n );
+			p = block;
+		}
+#if defined( __AVX2__ )
+		__m256i needle = _mm256_set1_epi8( c );
+		uint64_t lo = static_cast<uint32_t>( _mm256_movemask_epi8( _mm256_cmpeq_epi8( _mm256_loadu_si256( reinterpret_cast<const __m256i*>( p ) ), needle ) ) );
+		uint64_t hi = static_cast<uint32_t>( _mm256_movemask_epi8( _mm256_cmpeq_epi8( _mm256_loadu_si256( reinterpret_cast<const __m256i*>( p + 32 ) ), needle ) ) );
+		uint64_t mask = lo | ( hi << 32 );
+#elif defined( __SSE2__ )
+		__m128i needle = _mm_set1_epi8( c );
+		uint64_t mask = 0;
+		for ( int i = 0; i < 4; ++i ) {
+			__m128i chunk = _mm_loadu_si128( reinterpret_cast<const __m128i*>( p + i * 16 ) );
+			mask |= static_cast<uint64_t>( static_cast<uint16_t>( _mm_movemask_epi8( _mm_cmpeq_epi8( chunk, needle ) ) ) ) << ( i * 16 );
+		}
+#else
+		uint64_t mask = 0;
+		for ( int i = 0; i < 64; ++i ) {
+			mask |= static_cast<uint64_t>( p[ i ] == c ) << i;
+		}
+#endif
+		if ( n < 64 ) {
+			mask &= ( uint64_t{ 1 } << n ) - 1;
+		}
+		return mask;
+	}
+
+	// ====================
+    //  Decode Hex Column
+    // ====================
+
+	// Decodes objdump's space separated "xx xx xx" byte column into out.
+	// Returns std::nullopt if the column holds anything but two digit hex bytes.
+	std::optional<std::size_t> decode_hex_column( std::string_view column, std::span<uint8_t> out ) {
+		std::size_t count = 0;
+		std::size_t i = 0;
+		while ( true ) {
+			while ( i < column.size() && column[ i ] == ' ' ) {
+				++i;
+			}
+			if ( i == column.size() ) {
+				return count;
+			}
+			if ( i + 2 > column.size() || count == out.size() ) {
+				return std::nullopt;
+			}
+			int hi = hex_digit_table[ static_cast<uint8_t>( column[ i ] ) ];
+			int lo = hex_digit_table[ static_cast<uint8_t>( column[ i + 1 ] ) ];
+			if ( ( hi | lo ) < 0 || ( i + 2 < column.size() && column[ i + 2 ] != ' ' ) ) {
+				return std::nullopt;
+			}
+			out[ count++ ] = static_cast<uint8_t>( ( hi << 4 ) | lo );
+			i += 2;
+		}
+	}
+
 	// ===============
     //  Parse Address
     // ===============
@@ -27,27 +152,24 @@ namespace stig {
     // =======================
 
     std::expected<x86_instruction_parse_result,std::string> extract_machine_bytes( x86_instruction_parse_result p_result ) {
-    	std::istringstream iss( std::string( p_result.buffer ) );
-	    std::string token;
-	    iss.seekg( p_result.pos, std::ios::beg );
 	    std::vector<uint8_t> bytes;
-	    while ( iss >> token ) {
-	        if ( token.size() > 2 && token != "lock" ) { 
+	    while ( true ) {
+	    	std::size_t next = p_result.pos;
+	    	auto token = next_token_view( p_result.buffer, next );
+	        if ( token.empty() || ( token.size() > 2 && token != "lock" ) ) { 
 	        	break;
 	        }
-	        bool is_hex = token.find_first_not_of( "0123456789abcdefABCDEF" ) == std::string::npos;
-	        if ( !is_hex ) {
+	        auto value = decode_hex_byte( token );
+	        if ( !value ) {
 	        	if ( token == "cs" || token == "lock" ) {
-	        		p_result.pos = iss.tellg();
-	        		break;
+	        		p_result.pos = next;
 	        	} 
 	        	break;
 	        }
-	        p_result.pos = iss.tellg();
-	        uint8_t value = static_cast<uint8_t>( std::stoul( token, nullptr, 16 ) );
-	        bytes.push_back( value );
+	        p_result.pos = next;
+	        bytes.push_back( value.value() );
 	    }
-	    p_result.instruction.machine_bytes = std::move( bytes );
+	    p_result.instruction.machine_bytes.assign( bytes.begin(), bytes.end() );
 	    return p_result;
     } 
 
@@ -65,35 +187,21 @@ namespace stig {
 	    std::string token;
 	    iss.seekg( p_result.pos, std::ios::beg );
 	    iss >> token;
-	    auto it = mnemonic_map.find( token );
-		if ( it != mnemonic_map.end() ) {
-		    p_result.instruction.mnemonic = it->second;
+	    auto mnemonic = get_mnemonic( token );
+		if ( mnemonic ) {
+		    p_result.instruction.mnemonic = mnemonic.value();
 		} else {
 		    return std::unexpected( "Unknown Mnemonic: " + token );
 		}
+		if ( iss.eof() ) {
+			p_result.pos = p_result.buffer.size();
+			return p_result;
+		}
 	    p_result.pos = iss.tellg();
 	    ++p_result.pos; 
 	    return p_result;
     }
 
-    // ==============
-    //  Get Register
-    // ==============
-
-    std::optional<x86_register> get_register( const std::string& token ) {
-    	if ( token == "%eax" ) return x86_register::eax;
-    	if ( token == "%edx" ) return x86_register::edx;
-    	if ( token == "%edi" ) return x86_register::edi;
-    	if ( token == "%esi" ) return x86_register::esi;
-    	if ( token == "%rax" ) return x86_register::rax;
-    	if ( token == "%rbp" ) return x86_register::rbp;
-    	if ( token == "%rdi" ) return x86_register::rdi;
-    	if ( token == "%rip" ) return x86_register::rip;
-    	if ( token == "%rsp" ) return x86_register::rsp;
-    	if ( token == "%rsi" ) return x86_register::rsi;
-    	return std::nullopt;
-    }
-
     // ===============
     //  Get Immediate
     // ===============
@@ -101,7 +209,8 @@ namespace stig {
     std::optional<x86_immediate> get_immediate( const std::string& token ) {
     	if ( !token.empty() && token[ 0 ] == '$' ) {
 	        try {
-	            int64_t value = std::stoll( token.substr( 1 ), nullptr, 0 );
+	            // objdump prints sign-extended 64-bit immediates as unsigned hex.
+	            int64_t value = static_cast<int64_t>( std::stoull( token.substr( 1 ), nullptr, 0 ) );
 	            return x86_immediate{ value };
 	        } catch ( const std::exception& ) {
 	            return std::nullopt;
@@ -224,6 +333,7 @@ namespace stig {
     		 p_result.instruction.mnemonic == x86_mnemonic::ret ||
     		 p_result.instruction.mnemonic == x86_mnemonic::call ||
     		 p_result.instruction.mnemonic == x86_mnemonic::je ||
+    		 p_result.instruction.mnemonic == x86_mnemonic::jne ||
     		 p_result.instruction.mnemonic == x86_mnemonic::jmp ||
     		 p_result.instruction.mnemonic == x86_mnemonic::padding ) {
     		return p_result;
@@ -265,6 +375,7 @@ namespace stig {
     std::expected<x86_instruction_parse_result,std::string> parse_call( x86_instruction_parse_result p_result ) {
     	if ( p_result.instruction.mnemonic != x86_mnemonic::call && 
     		 p_result.instruction.mnemonic != x86_mnemonic::je &&
+    		 p_result.instruction.mnemonic != x86_mnemonic::jne &&
     		 p_result.instruction.mnemonic != x86_mnemonic::jmp ) {
     		return p_result;
     	}
@@ -317,84 +428,513 @@ namespace stig {
 	}
 
 
+	// ================
+    //  Parse Int View
+    // ================
+
+	// Accepts what std::stoll( token, nullptr, base ) accepts for base 0 and 16:
+	// an optional sign, an optional "0x" prefix and trailing junk after the digits.
+	// With wrap set it follows std::stoull instead, so 64-bit values wrap around.
+	std::optional<int64_t> parse_int_view( std::string_view token, int base, bool wrap = false ) {
+		std::size_t i = 0;
+		bool negative = false;
+		if ( i < token.size() && ( token[ i ] == '+' || token[ i ] == '-' ) ) {
+			negative = token[ i ] == '-';
+			++i;
+		}
+		if ( ( base == 0 || base == 16 ) && i + 2 < token.size() && token[ i ] == '0' &&
+			 ( token[ i + 1 ] == 'x' || token[ i + 1 ] == 'X' ) && std::isxdigit( static_cast<unsigned char>( token[ i + 2 ] ) ) ) {
+			base = 16;
+			i += 2;
+		} else if ( base == 0 ) {
+			base = ( i < token.size() && token[ i ] == '0' ) ? 8 : 10;
+		}
+		uint64_t magnitude{};
+		auto [ ptr, ec ] = std::from_chars( token.data() + i, token.data() + token.size(), magnitude, base );
+		if ( ec != std::errc() ) {
+			return std::nullopt;
+		}
+		if ( wrap ) {
+			return static_cast<int64_t>( negative ? 0 - magnitude : magnitude );
+		}
+		if ( negative ) {
+			if ( magnitude > static_cast<uint64_t>( INT64_MAX ) + 1 ) {
+				return std::nullopt;
+			}
+			return static_cast<int64_t>( 0 - magnitude );
+		}
+		if ( magnitude > static_cast<uint64_t>( INT64_MAX ) ) {
+			return std::nullopt;
+		}
+		return static_cast<int64_t>( magnitude );
+	}
+
+	// =================
+    //  Get Memory View
+    // =================
+
+	std::optional<x86_memory> get_memory_view( std::string_view token ) {
+		x86_memory result{};
+		auto open_paren = token.find( '(' );
+		auto close_paren = token.find( ')' );
+		if ( open_paren == std::string_view::npos || close_paren == std::string_view::npos ) {
+			return std::nullopt;
+		}
+		auto disp_str = token.substr( 0, open_paren );
+		auto reg_str = token.substr( open_paren + 1, close_paren - open_paren - 1 );
+		if ( !disp_str.empty() ) {
+			auto disp = parse_int_view( disp_str, 0 );
+			if ( !disp ) {
+				return std::nullopt;
+			}
+			result.displacement = disp.value();
+		}
+		auto first_comma = reg_str.find( ',' );
+		auto second_comma = std::string_view::npos;
+		if ( first_comma != std::string_view::npos ) {
+			second_comma = reg_str.find( ',', first_comma + 1 );
+		}
+		if ( second_comma != std::string_view::npos ) {
+			auto base = get_register( reg_str.substr( 0, first_comma ) );
+			auto index = get_register( reg_str.substr( first_comma + 1, second_comma - first_comma - 1 ) );
+			auto scale = parse_int_view( reg_str.substr( second_comma + 1 ), 0 );
+			if ( !base || !index || !scale ) {
+				return std::nullopt;
+			}
+			result.base = base.value();
+			result.index = index.value();
+			result.scale = static_cast<uint8_t>( scale.value() );
+			return result;
+		}
+		auto base = get_register( reg_str );
+		if ( !base ) {
+			return std::nullopt;
+		}
+		result.base = base.value();
+		return result;
+	}
+
+	// ==================
+    //  Get Operand View
+    // ==================
+
+	std::optional<x86_operand> get_operand_view( std::string_view token ) {
+		if ( auto reg = get_register( token ) ) {
+			return reg.value();
+		}
+		if ( !token.empty() && token[ 0 ] == '$' ) {
+			// objdump prints sign-extended 64-bit immediates as unsigned hex.
+			if ( auto imm = parse_int_view( token.substr( 1 ), 0, true ) ) {
+				return x86_immediate{ imm.value() };
+			}
+		}
+		if ( auto mem = get_memory_view( token ) ) {
+			return mem.value();
+		}
+		return std::nullopt;
+	}
+
+	// ===========================
+    //  Parse Compact Instruction
+    // ===========================
+
+	std::expected<x86_compact_instruction,std::string> parse_compact_instruction( std::string_view line ) {
+		x86_compact_instruction instruction;
+		std::size_t pos = 0;
+		while ( pos < line.size() && is_space( line[ pos ] ) ) {
+			++pos;
+		}
+		std::size_t colon_pos = line.find( ':', pos );
+		if ( colon_pos == std::string_view::npos ) {
+			return std::unexpected( "Missing ':' after Address" );
+		}
+		auto [ ptr, ec ] = std::from_chars( line.data() + pos, line.data() + colon_pos, instruction.address, 16 );
+		if ( ec != std::errc() ) {
+			return std::unexpected( "Invalid Address" );
+		}
+		pos = colon_pos + 1;
+
+		auto& bytes = instruction.machine_bytes;
+		std::size_t byte_count = 0;
+		// objdump lays lines out as "addr:\tbytes\tmnemonic operands"; when the tabs are
+		// there the byte column is decoded in one go, otherwise fall back to tokens.
+		uint64_t tabs = match_mask64( line.data() + pos, std::min<std::size_t>( 64, line.size() - pos ), '\t' );
+		std::optional<std::size_t> decoded;
+		if ( tabs & 1 ) {
+			tabs &= tabs - 1;
+			std::size_t column_end = tabs ? pos + std::countr_zero( tabs ) : line.size();
+			decoded = decode_hex_column( line.substr( pos + 1, column_end - pos - 1 ), bytes );
+			if ( decoded ) {
+				byte_count = decoded.value();
+				pos = column_end;
+				std::size_t next = pos;
+				auto prefix = next_token_view( line, next );
+				if ( prefix == "cs" || prefix == "lock" ) {
+					pos = next;
+				}
+			}
+		}
+		while ( !decoded ) {
+			std::size_t next = pos;
+			auto token = next_token_view( line, next );
+			if ( token.empty() || ( token.size() > 2 && token != "lock" ) ) {
+				break;
+			}
+			auto value = decode_hex_byte( token );
+			if ( !value ) {
+				if ( token == "cs" || token == "lock" ) {
+					pos = next;
+				}
+				break;
+			}
+			if ( byte_count == bytes.size() ) {
+				return std::unexpected( "Too many Machine Bytes" );
+			}
+			bytes[ byte_count++ ] = value.value();
+			pos = next;
+		}
+		instruction.byte_count = static_cast<uint8_t>( byte_count );
+		if ( std::all_of( bytes.begin(), bytes.begin() + byte_count, []( uint8_t byte ) { return byte == 0x00; } ) ) {
+			instruction.mnemonic = x86_mnemonic::padding;
+			return instruction;
+		}
+
+		auto mnemonic_token = next_token_view( line, pos );
+		auto mnemonic = get_mnemonic( mnemonic_token );
+		if ( !mnemonic ) {
+			return std::unexpected( "Unknown Mnemonic: " + std::string( mnemonic_token ) );
+		}
+		instruction.mnemonic = mnemonic.value();
+
+		switch ( instruction.mnemonic ) {
+			case x86_mnemonic::endbr64:
+			case x86_mnemonic::ret:
+				return instruction;
+			case x86_mnemonic::call:
+			case x86_mnemonic::je:
+			case x86_mnemonic::jne:
+			case x86_mnemonic::jmp: {
+				auto target = next_token_view( line, pos );
+				if ( !target.empty() && target[ 0 ] == '*' ) {
+					auto name = target.substr( 1 );
+					if ( auto reg = get_register( name ) ) {
+						instruction.push_operand( reg.value() );
+						return instruction;
+					}
+					if ( auto mem = get_memory_view( name ) ) {
+						instruction.push_operand( mem.value() );
+						return instruction;
+					}
+					return std::unexpected( "Unrecognized Register: " + std::string( name ) );
+				}
+				auto address = parse_int_view( target, 16 );
+				if ( !address ) {
+					return std::unexpected( "Invalid Address: " + std::string( target ) );
+				}
+				instruction.push_operand( x86_address{ static_cast<uint64_t>( address.value() ) } );
+				return instruction;
+			}
+			default:
+				break;
+		}
+
+		auto operand_token = next_token_view( line, pos );
+		if ( operand_token.empty() ) {
+			return instruction;
+		}
+		instruction.operand_count = 0;
+		bool inside_paren = false;
+		std::size_t start = 0;
+		for ( std::size_t i = 0; i <= operand_token.size(); ++i ) {
+			char c = i < operand_token.size() ? operand_token[ i ] : ',';
+			if ( c == '(' ) {
+				inside_paren = true;
+			}
+			if ( c == ')' ) {
+				inside_paren = false;
+			}
+			if ( c != ',' || ( inside_paren && i < operand_token.size() ) ) {
+				continue;
+			}
+			auto part = operand_token.substr( start, i - start );
+			start = i + 1;
+			if ( i == operand_token.size() && part.empty() ) {
+				break;
+			}
+			auto operand = get_operand_view( part );
+			if ( !operand ) {
+				return std::unexpected( "Invalid Operand: " + std::string( part ) );
+			}
+			if ( !instruction.push_operand( operand.value() ) ) {
+				return std::unexpected( "Too many Operands" );
+			}
+		}
+		return instruction;
+	}
+
+	// ============================
+    //  Parse x86 Instruction View
+    // ============================
+
+	std::expected<x86_instruction,std::string> parse_x86_instruction_view( std::string_view line, std::pmr::memory_resource* resource ) {
+		auto instruction = parse_compact_instruction( line );
+		if ( !instruction ) {
+			return std::unexpected( instruction.error() );
+		}
+		return convert_to_instruction( instruction.value(), resource );
+	}
+
+
 	// ================
     //  Parse Function
     // ================
 
-    std::expected<std::string,std::string> parse_function_name( const std::string& token ) {
+    std::expected<std::string,std::string> parse_function_name( std::string_view token ) {
     	auto open_angle = token.find( '<' );
         auto close_angle = token.find( '>' );
 
-        if ( open_angle == std::string::npos || close_angle == std::string::npos ) {
+        if ( open_angle == std::string_view::npos || close_angle == std::string_view::npos ) {
         	return std::unexpected( "No Angle Brackets found" );
         }
-        std::string function_name = token.substr( open_angle + 1, close_angle - open_angle - 1 );
+        std::string function_name( token.substr( open_angle + 1, close_angle - open_angle - 1 ) );
         return function_name;
     }
 
-    // ======
-    //  Trim
-    // ======
+	// ===========
+    //  Trim View
+    // ===========
 
-    std::string trim( const std::string& s ) {
-	    auto start = std::find_if_not( s.begin(), s.end(), ::isspace );
-	    auto end   = std::find_if_not( s.rbegin(), s.rend(), ::isspace ).base();
-	    if ( start >= end ) {
-	        return "";
-	    }
-	    return std::string( start, end );
+	std::string_view trim_view( std::string_view s ) {
+		std::size_t start = 0;
+		std::size_t end = s.size();
+		while ( start < end && is_space( s[ start ] ) ) {
+			++start;
+		}
+		while ( end > start && is_space( s[ end - 1 ] ) ) {
+			--end;
+		}
+		return s.substr( start, end - start );
 	}
 
-    // =============
-    //  Split Lines
-    // =============
+	// ================
+    //  Next Line View
+    // ================
 
-    std::vector<std::string> split_lines( const std::string& text ) {
-	    std::vector<std::string> lines;
-	    std::istringstream stream( text );
-	    std::string line;
-	    while ( std::getline( stream, line ) ) {
-	        if ( !line.empty() ) {  
-	            lines.push_back( trim( line ) );
-	        }
-	    }
-	    return lines;
+	std::string_view next_line_view( std::string_view text, std::size_t& pos ) {
+		std::size_t end = text.find( '\n', pos );
+		if ( end == std::string_view::npos ) {
+			end = text.size();
+		}
+		auto line = text.substr( pos, end - pos );
+		pos = end + 1;
+		return line;
+	}
+
+	// ==============
+    //  Line Scanner
+    // ==============
+
+	std::string_view line_scanner::next() {
+		std::size_t start = pos;
+		while ( newlines == 0 ) {
+			if ( block >= text.size() ) {
+				pos = text.size() + 1;
+				return text.substr( start );
+			}
+			std::size_t n = std::min<std::size_t>( 64, text.size() - block );
+			newlines = match_mask64( text.data() + block, n, '\n' );
+			block += 64;
+		}
+		std::size_t end = block - 64 + std::countr_zero( newlines );
+		newlines &= newlines - 1;
+		pos = end + 1;
+		return text.substr( start, end - start );
 	}
 
 	// ================
     //  Parse Function
     // ================
 
-	std::expected<function,std::string> parse_function( const std::string& token ) {
-		function func;
-		auto lines = split_lines( token );
-		if ( lines.empty() ) {
-			return std::unexpected( "Function Body is empty" );
-		}
-		auto name_result = parse_function_name( lines[ 0 ] );
-		if ( !name_result ) {
-			return std::unexpected( name_result.error() );
-		}
-		func.name = name_result.value();
-		for ( std::size_t i = 1; i < lines.size(); ++i ) {
-			auto parse_result = parse_x86_instruction( lines[ i ] );
+	// Shared by parse_function and parse_compact_function: the first non-empty line names
+	// the function, every following one is handed to parse_line.
+	template<typename Function, typename ParseLine>
+	std::expected<Function,std::string> parse_function_lines( std::string_view text, Function func, ParseLine parse_line ) {
+		bool name_found = false;
+		line_scanner lines( text );
+		while ( lines.has_next() ) {
+			auto line = trim_view( lines.next() );
+			if ( line.empty() ) {
+				continue;
+			}
+			if ( !name_found ) {
+				auto name_result = parse_function_name( line );
+				if ( !name_result ) {
+					return std::unexpected( name_result.error() );
+				}
+				func.name = name_result.value();
+				name_found = true;
+				continue;
+			}
+			auto parse_result = parse_line( line );
 			if ( !parse_result ) {
 				return std::unexpected( parse_result.error() );
 			}
-			auto& parsed_instruction = parse_result.value();
-			func.instructions.push_back( parsed_instruction.instruction );
+			func.instructions.push_back( std::move( parse_result.value() ) );
+		}
+		if ( !name_found ) {
+			return std::unexpected( "Function Body is empty" );
 		}
  		return func;
 	}
 
+	std::expected<function,std::string> parse_function( std::string_view text, std::pmr::memory_resource* resource ) {
+		return parse_function_lines( text, function( resource ), [ resource ]( std::string_view line ) {
+			return parse_x86_instruction_view( line, resource );
+		} );
+	}
+
+	std::expected<compact_function,std::string> parse_compact_function( std::string_view text, std::pmr::memory_resource* resource ) {
+		compact_function func{ std::pmr::string( resource ), std::pmr::vector<x86_compact_instruction>( resource ) };
+		return parse_function_lines( text, std::move( func ), parse_compact_instruction );
+	}
+
 	// ====================
     //  Convert to Program
     // ====================
 
-    std::expected<program,std::string> convert_to_program( function& func ) {
-    	program result;
+    std::expected<program,std::string> convert_to_program( function& func, std::pmr::memory_resource* resource ) {
+    	program result{ 0, std::pmr::unordered_map<uint64_t,x86_instruction>( resource ), 0 };
     	for ( auto& instr : func.instructions ) {
-    		result.instrs.insert( std::pair<uint64_t,x86_instruction>{ instr.address, instr } );
+    		result.instrs.emplace( instr.address, instr );
+    	}
+    	return result;
+    }
+
+	// ======================
+    //  Compact Instructions
+    // ======================
+
+    x86_operand x86_compact_instruction::operand( std::size_t i ) const {
+    	switch ( kind( i ) ) {
+    		case x86_operand_kind::reg:
+    			return regs[ i ];
+    		case x86_operand_kind::immediate:
+    			return x86_immediate{ values[ i ] };
+    		case x86_operand_kind::address:
+    			return x86_address{ static_cast<uint64_t>( values[ i ] ) };
+    		default: {
+    			x86_memory memory;
+    			if ( operand_flags[ i ] & has_base ) {
+    				memory.base = regs[ i ];
+    			}
+    			if ( operand_flags[ i ] & has_index ) {
+    				memory.index = indexes[ i ];
+    			}
+    			if ( operand_flags[ i ] & has_scale ) {
+    				memory.scale = scales[ i ];
+    			}
+    			if ( operand_flags[ i ] & has_displacement ) {
+    				memory.displacement = values[ i ];
+    			}
+    			return memory;
+    		}
+    	}
+    }
+
+    bool x86_compact_instruction::push_operand( const x86_operand& operand ) {
+    	if ( operand_count == no_operands ) {
+    		operand_count = 0;
+    	}
+    	if ( operand_count == max_operands ) {
+    		return false;
+    	}
+    	std::size_t i = operand_count++;
+    	operand_flags[ i ] = static_cast<uint8_t>( operand.index() );
+    	std::visit( [ & ]( auto&& op ) {
+    		using T = std::decay_t<decltype( op )>;
+    		if constexpr ( std::is_same_v<T,x86_register> ) {
+    			regs[ i ] = op;
+    		} else if constexpr ( std::is_same_v<T,x86_immediate> ) {
+    			values[ i ] = op.value;
+    		} else if constexpr ( std::is_same_v<T,x86_address> ) {
+    			values[ i ] = static_cast<int64_t>( op.addr );
+    		} else {
+    			if ( op.base ) {
+    				operand_flags[ i ] |= has_base;
+    				regs[ i ] = op.base.value();
+    			}
+    			if ( op.index ) {
+    				operand_flags[ i ] |= has_index;
+    				indexes[ i ] = op.index.value();
+    			}
+    			if ( op.scale ) {
+    				operand_flags[ i ] |= has_scale;
+    				scales[ i ] = op.scale.value();
+    			}
+    			if ( op.displacement ) {
+    				operand_flags[ i ] |= has_displacement;
+    				values[ i ] = op.displacement.value();
+    			}
+    		}
+    	}, operand );
+    	return true;
+    }
+
+    std::expected<x86_compact_instruction,std::string> convert_to_compact( const x86_instruction& instruction ) {
+    	x86_compact_instruction result;
+    	if ( instruction.machine_bytes.size() > x86_compact_instruction::max_bytes ) {
+    		return std::unexpected( "Too many Machine Bytes" );
+    	}
+    	result.address = instruction.address;
+    	std::copy( instruction.machine_bytes.begin(), instruction.machine_bytes.end(), result.machine_bytes.begin() );
+    	result.byte_count = static_cast<uint8_t>( instruction.machine_bytes.size() );
+    	result.mnemonic = instruction.mnemonic;
+    	if ( instruction.operands ) {
+    		result.operand_count = 0;
+    		for ( const auto& operand : instruction.operands.value() ) {
+    			if ( !result.push_operand( operand ) ) {
+    				return std::unexpected( "Too many Operands" );
+    			}
+    		}
+    	}
+    	return result;
+    }
+
+    std::expected<compact_function,std::string> convert_to_compact( const function& func, std::pmr::memory_resource* resource ) {
+    	compact_function result{ std::pmr::string( func.name, resource ), std::pmr::vector<x86_compact_instruction>( resource ) };
+    	result.instructions.reserve( func.instructions.size() );
+    	for ( const auto& instruction : func.instructions ) {
+    		auto compact = convert_to_compact( instruction );
+    		if ( !compact ) {
+    			return std::unexpected( compact.error() );
+    		}
+    		result.instructions.push_back( compact.value() );
+    	}
+    	return result;
+    }
+
+    x86_instruction convert_to_instruction( const x86_compact_instruction& instruction, std::pmr::memory_resource* resource ) {
+    	x86_instruction result( resource );
+    	result.address = instruction.address;
+    	auto bytes = instruction.bytes();
+    	result.machine_bytes.assign( bytes.begin(), bytes.end() );
+    	result.mnemonic = instruction.mnemonic;
+    	if ( instruction.has_operands() ) {
+    		auto& operands = result.operands.emplace( resource );
+    		operands.reserve( instruction.operand_count );
+    		for ( std::size_t i = 0; i < instruction.operand_count; ++i ) {
+    			operands.push_back( instruction.operand( i ) );
+    		}
+    	}
+    	return result;
+    }
+
+    function convert_to_function( const compact_function& func, std::pmr::memory_resource* resource ) {
+    	function result( resource );
+    	result.name = func.name;
+    	result.instructions.reserve( func.instructions.size() );
+    	for ( const auto& instruction : func.instructions ) {
+    		result.instructions.push_back( convert_to_instruction( instruction, resource ) );
     	}
     	return result;
     }
@@ -483,6 +1023,32 @@ namespace stig {
     // =============
 
     std::expected<void,std::string> execute_mov( const x86_instruction& mov_instr, x86_cpu& cpu ) {
+    	guest_memory memory;
+    	return execute_mov( mov_instr, cpu, memory );
+    }
+
+    std::expected<uint64_t,std::string> effective_address( const x86_instruction& instr, const x86_memory& memory, x86_cpu& cpu ) {
+    	uint64_t address = static_cast<uint64_t>( memory.displacement.value_or( 0 ) );
+    	if ( memory.base == x86_register::rip ) {
+    		address += instr.address + instr.machine_bytes.size();
+    	} else if ( memory.base ) {
+    		auto base = cpu.get( memory.base.value() );
+    		if ( !base ) {
+    			return std::unexpected( base.error() );
+    		}
+    		address += base.value();
+    	}
+    	if ( memory.index ) {
+    		auto index = cpu.get( memory.index.value() );
+    		if ( !index ) {
+    			return std::unexpected( index.error() );
+    		}
+    		address += index.value() * memory.scale.value_or( 1 );
+    	}
+    	return address;
+    }
+
+    std::expected<void,std::string> execute_mov( const x86_instruction& mov_instr, x86_cpu& cpu, guest_memory& memory ) {
     	if ( !mov_instr.operands ) {
     		return std::unexpected( "Mov Instruction does not contain any Operands" );
     	}
@@ -493,48 +1059,53 @@ namespace stig {
     		return std::unexpected( "Mov Instruction contains more than two Operands" );
     	}
     	auto& operands = mov_instr.operands.value();
-    	bool unhandled = false;
-    	std::optional<std::string> error;
-    	auto val = std::visit( [ &cpu, &unhandled, &error ]( auto&& op ) {
+    	// The register operand sets the access size; mov has no memory-to-memory form.
+    	std::size_t size = 0;
+    	for ( const auto& operand : operands ) {
+    		if ( const auto* reg = std::get_if<x86_register>( &operand ) ) {
+    			auto width = get_register_width( *reg );
+    			if ( !width ) {
+    				return std::unexpected( width.error() );
+    			}
+    			size = static_cast<std::size_t>( width.value() ) / 8;
+    		}
+    	}
+    	if ( size == 0 ) {
+    		return std::unexpected( "Mov Instruction has no Register Operand" );
+    	}
+    	auto val = std::visit( [ & ]( auto&& op ) -> std::expected<uint64_t,std::string> {
     		using T = std::decay_t<decltype( op )>;
     		if constexpr ( std::is_same_v<T,x86_register> ) {
-        		if ( auto res = cpu.get( op ) ) {
-        			return res.value();	
-        		} else {
-        			error = res.error();
-        		}
-    		}
-    		unhandled = true;
-    		return uint64_t{0};
-    	}, operands[ 0 ] );
-    	if ( unhandled ) {
-    		if ( error.has_value() ) {
-    			return std::unexpected( error.value() );
+    			return cpu.get( op );
+    		} else if constexpr ( std::is_same_v<T,x86_immediate> ) {
+    			return static_cast<uint64_t>( op.value );
+    		} else if constexpr ( std::is_same_v<T,x86_memory> ) {
+    			auto address = effective_address( mov_instr, op, cpu );
+    			if ( !address ) {
+    				return std::unexpected( address.error() );
+    			}
+    			return memory.load( address.value(), size );
     		} else {
     			return std::unexpected( "Unhandled Operand" );
     		}
+    	}, operands[ 0 ] );
+    	if ( !val ) {
+    		return std::unexpected( val.error() );
     	}
-    	std::visit( [ &cpu, val, &unhandled, &error ]( auto&& op ) {
-			using T = std::decay_t<decltype( op )>;
-			if constexpr ( std::is_same_v<T,x86_register> ) {
-        		auto res = cpu.set( op, val );
-        		if ( !res ) {
-        			error = res.error();
-        		} else {
-        			return;
-        		}         
+    	return std::visit( [ & ]( auto&& op ) -> std::expected<void,std::string> {
+    		using T = std::decay_t<decltype( op )>;
+    		if constexpr ( std::is_same_v<T,x86_register> ) {
+    			return cpu.set( op, val.value() );
+    		} else if constexpr ( std::is_same_v<T,x86_memory> ) {
+    			auto address = effective_address( mov_instr, op, cpu );
+    			if ( !address ) {
+    				return std::unexpected( address.error() );
+    			}
+    			return memory.store( address.value(), val.value(), size );
+    		} else {
+    			return std::unexpected( "Unhandled Operand" );
     		}
-    		unhandled = true;
-    		return;
-		}, operands[ 1 ] );
-		if ( unhandled ) {
-			if ( error.has_value() ) {
-				return std::unexpected( error.value() );
-			} else {
-				return std::unexpected( "Unhandled Operand" );
-			}
-		}
-		return{};
+    	}, operands[ 1 ] );
     }
 
     // ==============
@@ -613,6 +1184,35 @@ namespace stig {
     	return {};
     }
 
+    std::expected<void,std::string> execute_movb( const x86_instruction& movb_instr, x86_cpu& cpu, guest_memory& memory ) {
+    	if ( !movb_instr.operands || movb_instr.operands->size() != 2 ) {
+    		return std::unexpected( "Movb Instruction does not contain two Operands" );
+    	}
+    	auto& operands = movb_instr.operands.value();
+    	auto value = std::visit( [ &cpu ]( auto&& op ) -> std::expected<uint64_t,std::string> {
+    		using T = std::decay_t<decltype( op )>;
+    		if constexpr ( std::is_same_v<T,x86_register> ) {
+    			return cpu.get( op );
+    		} else if constexpr ( std::is_same_v<T,x86_immediate> ) {
+    			return static_cast<uint64_t>( op.value );
+    		} else {
+    			return std::unexpected( "Left-Hand Operand unhandled" );
+    		}
+    	}, operands[ 0 ] );
+    	if ( !value ) {
+    		return std::unexpected( value.error() );
+    	}
+    	const auto* destination = std::get_if<x86_memory>( &operands[ 1 ] );
+    	if ( destination == nullptr ) {
+    		return std::unexpected( "Right-Hand Operand unhandled" );
+    	}
+    	auto address = effective_address( movb_instr, *destination, cpu );
+    	if ( !address ) {
+    		return std::unexpected( address.error() );
+    	}
+    	return memory.store( address.value(), value.value(), 1 );
+    }
+
     // =============
     //  Execute Cmp
     // =============
@@ -681,7 +1281,7 @@ namespace stig {
     //  Execute Push
     // ==============
 
-    std::expected<void,std::string> execute_push( const x86_instruction& push_instr, x86_cpu& cpu ) {
+    std::expected<void,std::string> execute_push( const x86_instruction& push_instr, x86_cpu& cpu, guest_memory& memory ) {
     	if ( !push_instr.operands ) {
     		return std::unexpected( "Push Instruction does not contain any Operands" );
     	}
@@ -719,9 +1319,11 @@ namespace stig {
     		}
     	}
     	int size = reg_width / 8;
-    	for ( int i = 0; i < size; ++i ) {
-        	cpu.stack.push( ( val >> ( i * 8 ) ) & 0xff );
-        } 
+    	uint64_t rsp = static_cast<uint64_t>( cpu.rsp ) - size;
+    	if ( auto result = memory.store( rsp, val, size ); !result ) {
+    		return std::unexpected( result.error() );
+    	}
+    	cpu.rsp = static_cast<int64_t>( rsp );
         return {};
     }
 
@@ -729,7 +1331,7 @@ namespace stig {
     //  Execute Pop
     // =============
 
-    std::expected<void,std::string> execute_pop( const x86_instruction& pop_instr, x86_cpu& cpu ) {
+    std::expected<void,std::string> execute_pop( const x86_instruction& pop_instr, x86_cpu& cpu, guest_memory& memory ) {
     	if ( !pop_instr.operands ) {
     		return std::unexpected( "Pop Instruction does not contain any Operands" );
     	}
@@ -760,14 +1362,15 @@ namespace stig {
 	    	}
 	    }
 	    int size = reg_width / 8;
-	    uint64_t val = 0;
-	    for ( int i = 0; i < size; ++i ) {
-	        if ( cpu.stack.empty() ) {
-	            return std::unexpected( "Stack Underflow on POP" );
-	        }
-	        val |= static_cast<uint64_t>( cpu.stack.top() ) << ( i * 8 );
-	        cpu.stack.pop();
+	    if ( static_cast<uint64_t>( cpu.rsp ) == guest_stack::top ) {
+	        return std::unexpected( "Stack Underflow on POP" );
 	    }
+	    auto loaded = memory.load( static_cast<uint64_t>( cpu.rsp ), size );
+	    if ( !loaded ) {
+	        return std::unexpected( loaded.error() );
+	    }
+	    uint64_t val = loaded.value();
+	    cpu.rsp += size;
 	    std::visit( [ &cpu, val, &unhandled, &error ]( auto&& op ) {
 	        using T = std::decay_t<decltype( op )>;
 	        if constexpr ( std::is_same_v<T,x86_register> ) {
@@ -797,7 +1400,7 @@ namespace stig {
 		if ( !test_instr.operands ) {
 			return std::unexpected( "Test Instruction does not contain any Operands" );
 		}
-		if ( !test_instr.operands->size() != 2 ) {
+		if ( test_instr.operands->size() != 2 ) {
 			return std::unexpected( "Test Instruction does not contain two Operands" );
 		}
     	auto& operands = test_instr.operands.value();
@@ -966,20 +1569,19 @@ namespace stig {
     //  Execute Ret
     // =============
 
-    std::expected<void,std::string> execute_ret( const x86_instruction& ret_instr, x86_cpu& cpu ) {
+    std::expected<void,std::string> execute_ret( const x86_instruction& ret_instr, x86_cpu& cpu, guest_memory& memory ) {
     	if ( ret_instr.operands.has_value() && !ret_instr.operands->empty() ) {
     		return std::unexpected( "Ret Instruction contains Operands" );
     	}
-    	constexpr int size = 8;
-    	uint64_t val = 0;
-    	for ( int i = 0; i < size; ++i ) {
-    		if ( cpu.stack.empty() ) {
-    			return std::unexpected( "Stack Underflow on RET" );
-    		}
-    		val |= static_cast<uint64_t>( cpu.stack.top() ) << ( i * 8 );
-        	cpu.stack.pop();
+    	if ( static_cast<uint64_t>( cpu.rsp ) == guest_stack::top ) {
+    		return std::unexpected( "Stack Underflow on RET" );
     	}
-    	cpu.rip = static_cast<int64_t>( val );
+    	auto val = memory.load( static_cast<uint64_t>( cpu.rsp ), 8 );
+    	if ( !val ) {
+    		return std::unexpected( val.error() );
+    	}
+    	cpu.rsp += 8;
+    	cpu.rip = static_cast<int64_t>( val.value() );
     	return {};
     }
 
@@ -1036,6 +1638,7 @@ namespace stig {
     std::expected<void,std::string> execute_jne( const x86_instruction& jne_instr, x86_cpu& cpu ) {
     	if ( cpu.zero_flag ) {
     		cpu.increment_rpi( jne_instr.machine_bytes.size() );
+    		return {};
     	}
     	auto& operands = jne_instr.operands.value();
     	uint64_t addr{};
@@ -1065,6 +1668,7 @@ namespace stig {
     std::expected<void,std::string> execute_je( const x86_instruction& je_instr, x86_cpu& cpu ) {
     	if ( !cpu.zero_flag ) {
     		cpu.increment_rpi( je_instr.machine_bytes.size() );
+    		return {};
     	}
     	auto& operands = je_instr.operands.value();
     	uint64_t addr{};
@@ -1133,213 +1737,3180 @@ namespace stig {
     	}
     }
 
-    // =======================
-    //  Get Empty Line Offset
-    // =======================
+    // =============
+    //  Execute And
+    // =============
 
-    int get_empty_line_offset( std::ifstream& file, std::size_t start_line ) {
-    	std::streampos original_pos = file.tellg();
-    	file.clear();
-    	file.seekg(0);
-    	std::string line;
-    	std::size_t current = 0;
-    	while ( current < start_line && std::getline( file, line ) ) {
-    		++current;	
+    std::expected<void,std::string> execute_and( const x86_instruction& and_instr, x86_cpu& cpu ) {
+    	if ( !and_instr.operands || and_instr.operands->size() != 2 ) {
+    		return std::unexpected( "And Instruction does not contain two Operands" );
     	}
-    	if ( current != start_line ) {
-    		file.clear();
-    		file.seekg( original_pos );
-    		return -1;
+    	auto& operands = and_instr.operands.value();
+    	auto lhs = std::visit( [ &cpu ]( auto&& op ) -> std::expected<uint64_t,std::string> {
+    		using T = std::decay_t<decltype( op )>;
+    		if constexpr ( std::is_same_v<T,x86_register> ) {
+    			return cpu.get( op );
+    		} else if constexpr ( std::is_same_v<T,x86_immediate> ) {
+    			return static_cast<uint64_t>( op.value );
+    		} else {
+    			return std::unexpected( "Left-Hand Operand not handled" );
+    		}
+    	}, operands[ 0 ] );
+    	if ( !lhs ) {
+    		return std::unexpected( lhs.error() );
     	}
-    	int offset = 0;
-    	while ( std::getline( file, line ) ) {
-    		if ( line.empty() ) {
-    			file.clear();
-    			file.seekg( original_pos );
-    			++offset;
-    			return offset;
+    	const auto* target = std::get_if<x86_register>( &operands[ 1 ] );
+    	if ( target == nullptr ) {
+    		return std::unexpected( "Right-Hand Operand not handled" );
+    	}
+    	auto rhs = cpu.get( *target );
+    	if ( !rhs ) {
+    		return std::unexpected( rhs.error() );
+    	}
+    	uint64_t result = lhs.value() & rhs.value();
+    	cpu.zero_flag = ( result == 0 );
+    	cpu.sign_flag = ( result >> 63 ) & 1;
+    	cpu.carry_flag = false;
+    	cpu.overflow_flag = false;
+    	return cpu.set( *target, result );
+    }
+
+    // =====================
+    //  Execute Cmpb / Cmpq
+    // =====================
+
+    // AT&T order: the flags are those of operands[ 1 ] - operands[ 0 ] at size bytes.
+    std::expected<void,std::string> execute_compare( const x86_instruction& instr, x86_cpu& cpu, guest_memory& memory, std::size_t size ) {
+    	if ( !instr.operands || instr.operands->size() != 2 ) {
+    		return std::unexpected( "Compare Instruction does not contain two Operands" );
+    	}
+    	std::array<uint64_t,2> values{};
+    	for ( std::size_t i = 0; i < 2; ++i ) {
+    		auto value = std::visit( [ & ]( auto&& op ) -> std::expected<uint64_t,std::string> {
+    			using T = std::decay_t<decltype( op )>;
+    			if constexpr ( std::is_same_v<T,x86_register> ) {
+    				return cpu.get( op );
+    			} else if constexpr ( std::is_same_v<T,x86_immediate> ) {
+    				return static_cast<uint64_t>( op.value );
+    			} else if constexpr ( std::is_same_v<T,x86_memory> ) {
+    				auto address = effective_address( instr, op, cpu );
+    				if ( !address ) {
+    					return std::unexpected( address.error() );
+    				}
+    				return memory.load( address.value(), size );
+    			} else {
+    				return std::unexpected( "Unhandled Operand" );
+    			}
+    		}, instr.operands.value()[ i ] );
+    		if ( !value ) {
+    			return std::unexpected( value.error() );
     		}
-    		++offset;
+    		values[ i ] = value.value();
     	}
-    	file.clear();
-    	file.seekg( original_pos );
-    	return -1;
+    	unsigned shift = 64 - static_cast<unsigned>( size ) * 8;
+    	uint64_t lhs = values[ 1 ] << shift;
+    	uint64_t rhs = values[ 0 ] << shift;
+    	uint64_t diff = lhs - rhs;
+    	cpu.zero_flag = ( diff == 0 );
+    	cpu.sign_flag = diff >> 63;
+    	cpu.carry_flag = ( lhs < rhs );
+    	cpu.overflow_flag = ( ( lhs ^ rhs ) & ( lhs ^ diff ) ) >> 63;
+    	return {};
+    }
+
+    std::expected<void,std::string> execute_cmpb( const x86_instruction& cmpb_instr, x86_cpu& cpu ) {
+    	guest_memory memory;
+    	return execute_cmpb( cmpb_instr, cpu, memory );
+    }
+
+    std::expected<void,std::string> execute_cmpb( const x86_instruction& cmpb_instr, x86_cpu& cpu, guest_memory& memory ) {
+    	return execute_compare( cmpb_instr, cpu, memory, 1 );
+    }
+
+    std::expected<void,std::string> execute_cmpq( const x86_instruction& cmpq_instr, x86_cpu& cpu ) {
+    	guest_memory memory;
+    	return execute_cmpq( cmpq_instr, cpu, memory );
+    }
+
+    std::expected<void,std::string> execute_cmpq( const x86_instruction& cmpq_instr, x86_cpu& cpu, guest_memory& memory ) {
+    	return execute_compare( cmpq_instr, cpu, memory, 8 );
+    }
+
+    // =============
+    //  Execute Jmp
+    // =============
+
+    std::expected<void,std::string> execute_jmp( const x86_instruction& jmp_instr, x86_cpu& cpu ) {
+    	guest_memory memory;
+    	return execute_jmp( jmp_instr, cpu, memory );
+    }
+
+    std::expected<void,std::string> execute_jmp( const x86_instruction& jmp_instr, x86_cpu& cpu, guest_memory& memory ) {
+    	if ( !jmp_instr.operands || jmp_instr.operands->size() != 1 ) {
+    		return std::unexpected( "Jmp Instruction does not contain one Operand" );
+    	}
+    	auto target = std::visit( [ & ]( auto&& op ) -> std::expected<uint64_t,std::string> {
+    		using T = std::decay_t<decltype( op )>;
+    		if constexpr ( std::is_same_v<T,x86_address> ) {
+    			return op.addr;
+    		} else if constexpr ( std::is_same_v<T,x86_register> ) {
+    			return cpu.get( op );
+    		} else if constexpr ( std::is_same_v<T,x86_memory> ) {
+    			auto address = effective_address( jmp_instr, op, cpu );
+    			if ( !address ) {
+    				return std::unexpected( address.error() );
+    			}
+    			return memory.load( address.value(), 8 );
+    		} else {
+    			return std::unexpected( "Jmp Operand must be an Address" );
+    		}
+    	}, jmp_instr.operands->front() );
+    	if ( !target ) {
+    		return std::unexpected( target.error() );
+    	}
+    	cpu.rip = static_cast<int64_t>( target.value() );
+    	return {};
+    }
+
+    // ==============
+    //  Execute Call
+    // ==============
+
+    std::expected<void,std::string> execute_call( const x86_instruction& call_instr, x86_cpu& cpu, guest_memory& memory ) {
+    	if ( !call_instr.operands || call_instr.operands->size() != 1 ) {
+    		return std::unexpected( "Call Instruction does not contain one Operand" );
+    	}
+    	auto target = std::visit( [ & ]( auto&& op ) -> std::expected<uint64_t,std::string> {
+    		using T = std::decay_t<decltype( op )>;
+    		if constexpr ( std::is_same_v<T,x86_address> ) {
+    			return op.addr;
+    		} else if constexpr ( std::is_same_v<T,x86_register> ) {
+    			return cpu.get( op );
+    		} else if constexpr ( std::is_same_v<T,x86_memory> ) {
+    			auto address = effective_address( call_instr, op, cpu );
+    			if ( !address ) {
+    				return std::unexpected( address.error() );
+    			}
+    			return memory.load( address.value(), 8 );
+    		} else {
+    			return std::unexpected( "Call Operand must be an Address, Register or Memory" );
+    		}
+    	}, call_instr.operands->front() );
+    	if ( !target ) {
+    		return std::unexpected( target.error() );
+    	}
+    	uint64_t return_address = call_instr.address + call_instr.machine_bytes.size();
+    	uint64_t rsp = static_cast<uint64_t>( cpu.rsp ) - 8;
+    	if ( auto result = memory.store( rsp, return_address, 8 ); !result ) {
+    		return std::unexpected( result.error() );
+    	}
+    	cpu.rsp = static_cast<int64_t>( rsp );
+    	cpu.rip = static_cast<int64_t>( target.value() );
+    	return {};
     }
 
     // ===========================
-    //  Get Function Name Line No
+    //  Execute Hints and Padding
     // ===========================
 
-    std::optional<std::size_t> get_function_name_line_no( std::ifstream& file, const std::string& function_name ) {
-    	std::string line;
-    	std::size_t line_number = 0;
-    	std::regex func_regex( "^0*([0-9A-Fa-f]{1,16})\\s+<" + function_name + ">:\\s*$" );
-    	while ( std::getline( file, line ) ) {
-    		++line_number;
-    		if ( std::regex_search( line, func_regex ) ) {
-    			return line_number;
-    		}
-    	} 
-    	return std::nullopt;
+    std::expected<void,std::string> execute_endbr64( const x86_instruction&, x86_cpu& ) {
+    	return {};
+    }
+
+    std::expected<void,std::string> execute_nopl( const x86_instruction&, x86_cpu& ) {
+    	return {};
+    }
+
+    std::expected<void,std::string> execute_nopw( const x86_instruction&, x86_cpu& ) {
+    	return {};
+    }
+
+    std::expected<void,std::string> execute_padding( const x86_instruction&, x86_cpu& ) {
+    	return {};
+    }
+
+    // hlt is privileged; in user mode it faults, which stops the VM.
+    std::expected<void,std::string> execute_hlt( const x86_instruction&, x86_cpu& ) {
+    	return std::unexpected( "Privileged Instruction: hlt" );
     }
 
     // ==================
-    //  Get Function Str
+    //  Dispatch Program
     // ==================
 
-    std::expected<std::string,std::string> get_function_str( std::ifstream& file, const std::string& function_name ) {
-    	std::string result;
-    	auto line_no_opt = get_function_name_line_no( file, function_name );
-    	if ( !line_no_opt ) {
-    		return std::unexpected( "Function Name not found in File" );
+    constexpr instruction_handler make_instruction_handler( x86_mnemonic mnemonic ) {
+    	switch ( mnemonic ) {
+    		case x86_mnemonic::add:
+    			return []( x86_vm& vm, const x86_instruction& instruction ) { return execute_add( instruction, vm.cpu ); };
+    		case x86_mnemonic::and_:
+    			return []( x86_vm& vm, const x86_instruction& instruction ) { return execute_and( instruction, vm.cpu ); };
+    		case x86_mnemonic::call:
+    			return []( x86_vm& vm, const x86_instruction& instruction ) { return execute_call( instruction, vm.cpu, vm.memory ); };
+    		case x86_mnemonic::cmp:
+    			return []( x86_vm& vm, const x86_instruction& instruction ) { return execute_cmp( instruction, vm.cpu ); };
+    		case x86_mnemonic::cmpb:
+    			return []( x86_vm& vm, const x86_instruction& instruction ) { return execute_cmpb( instruction, vm.cpu, vm.memory ); };
+    		case x86_mnemonic::cmpq:
+    			return []( x86_vm& vm, const x86_instruction& instruction ) { return execute_cmpq( instruction, vm.cpu, vm.memory ); };
+    		case x86_mnemonic::endbr64:
+    			return []( x86_vm& vm, const x86_instruction& instruction ) { return execute_endbr64( instruction, vm.cpu ); };
+    		case x86_mnemonic::hlt:
+    			return []( x86_vm& vm, const x86_instruction& instruction ) { return execute_hlt( instruction, vm.cpu ); };
+    		case x86_mnemonic::je:
+    			return []( x86_vm& vm, const x86_instruction& instruction ) { return execute_je( instruction, vm.cpu ); };
+    		case x86_mnemonic::jmp:
+    			return []( x86_vm& vm, const x86_instruction& instruction ) { return execute_jmp( instruction, vm.cpu, vm.memory ); };
+    		case x86_mnemonic::jne:
+    			return []( x86_vm& vm, const x86_instruction& instruction ) { return execute_jne( instruction, vm.cpu ); };
+    		case x86_mnemonic::lea:
+    			return []( x86_vm& vm, const x86_instruction& instruction ) { return execute_lea( instruction, vm.cpu ); };
+    		case x86_mnemonic::mov:
+    			return []( x86_vm& vm, const x86_instruction& instruction ) { return execute_mov( instruction, vm.cpu, vm.memory ); };
+    		case x86_mnemonic::movb:
+    			return []( x86_vm& vm, const x86_instruction& instruction ) { return execute_movb( instruction, vm.cpu, vm.memory ); };
+    		case x86_mnemonic::nop:
+    		case x86_mnemonic::nopl:
+    			return []( x86_vm& vm, const x86_instruction& instruction ) { return execute_nopl( instruction, vm.cpu ); };
+    		case x86_mnemonic::nopw:
+    			return []( x86_vm& vm, const x86_instruction& instruction ) { return execute_nopw( instruction, vm.cpu ); };
+    		case x86_mnemonic::padding:
+    			return []( x86_vm& vm, const x86_instruction& instruction ) { return execute_padding( instruction, vm.cpu ); };
+    		case x86_mnemonic::pop:
+    			return []( x86_vm& vm, const x86_instruction& instruction ) { return execute_pop( instruction, vm.cpu, vm.memory ); };
+    		case x86_mnemonic::push:
+    			return []( x86_vm& vm, const x86_instruction& instruction ) { return execute_push( instruction, vm.cpu, vm.memory ); };
+    		case x86_mnemonic::ret:
+    			return []( x86_vm& vm, const x86_instruction& instruction ) { return execute_ret( instruction, vm.cpu, vm.memory ); };
+    		case x86_mnemonic::sar:
+    			return []( x86_vm& vm, const x86_instruction& instruction ) { return execute_sar( instruction, vm.cpu ); };
+    		case x86_mnemonic::shr:
+    			return []( x86_vm& vm, const x86_instruction& instruction ) { return execute_shr( instruction, vm.cpu ); };
+    		case x86_mnemonic::test:
+    			return []( x86_vm& vm, const x86_instruction& instruction ) { return execute_test( instruction, vm.cpu ); };
+    		case x86_mnemonic::xor_:
+    			return []( x86_vm& vm, const x86_instruction& instruction ) { return execute_xor( instruction, vm.cpu ); };
+    		default:
+    			return []( x86_vm&, const x86_instruction& ) -> std::expected<void,std::string> {
+    				return std::unexpected( "Unimplemented instruction" );
+    			};
     	}
-    	auto& line_no = line_no_opt.value();
-    	auto offset = get_empty_line_offset( file, line_no );
-    	if ( offset == -1 ) {
-    		return std::unexpected( "Error Calculating Empty Line Offset" );
+    }
+
+    constexpr auto instruction_handlers = [] {
+    	std::array<instruction_handler,mnemonic_infos.size()> handlers{};
+    	for ( const auto& info : mnemonic_infos ) {
+    		handlers[ static_cast<std::size_t>( info.mnemonic ) ] = make_instruction_handler( info.mnemonic );
     	}
-    	std::string line;
-    	file.clear();
-    	file.seekg( 0 );
-    	for ( std::size_t i = 0; i < line_no; ++i ) {
-    		std::getline( file, line );
+    	return handlers;
+    }();
+
+    instruction_handler get_instruction_handler( x86_mnemonic mnemonic ) {
+    	auto i = static_cast<std::size_t>( mnemonic );
+    	return i < instruction_handlers.size() ? instruction_handlers[ i ] : make_instruction_handler( mnemonic );
+    }
+
+    constexpr bool sets_rip( x86_mnemonic mnemonic ) {
+    	switch ( mnemonic ) {
+    		case x86_mnemonic::call:
+    		case x86_mnemonic::je:
+    		case x86_mnemonic::jmp:
+    		case x86_mnemonic::jne:
+    		case x86_mnemonic::ret:
+    			return true;
+    		default:
+    			return false;
     	}
-    	result += line + "\n";
-    	while ( offset > 0 ) {
-    		std::getline( file, line );
-    		result += line;
-    		if ( offset != 1 ) {
-    			result += "\n";
-    		}
-    		--offset;
+    }
+
+    // Mirrors the registers x86_cpu::get and set accept, except rip.
+    constexpr micro_register resolve_register( x86_register reg ) {
+    	switch ( reg ) {
+    		case x86_register::ebp:
+    			return { &x86_cpu::rbp, true };
+    		case x86_register::edx:
+    			return { &x86_cpu::rdx, true };
+    		case x86_register::rax:
+    			return { &x86_cpu::rax, false };
+    		case x86_register::rbp:
+    			return { &x86_cpu::rbp, false };
+    		case x86_register::rdi:
+    			return { &x86_cpu::rdi, false };
+    		case x86_register::rdx:
+    			return { &x86_cpu::rdx, false };
+    		case x86_register::rsp:
+    			return { &x86_cpu::rsp, false };
+    		case x86_register::rsi:
+    			return { &x86_cpu::rsi, false };
+    		case x86_register::r9:
+    			return { &x86_cpu::r9, false };
+    		default:
+    			return {};
     	}
-    	return result;
     }
 
-    // ==================
-    //  Extract Function
-    // ==================
+    uint64_t read_register( const x86_cpu& cpu, const micro_register& reg ) {
+    	auto value = static_cast<uint64_t>( cpu.*reg.field );
+    	return reg.dword ? static_cast<uint32_t>( value ) : value;
+    }
 
-    std::expected<function,std::string> extract_function( const std::string& file_name, const std::string& function_name ) {
-    	std::ifstream file( file_name );
-    	if ( !file ) {
-    		return std::unexpected( "Failed to Open File" );
+    void write_register( x86_cpu& cpu, const micro_register& reg, uint64_t value ) {
+    	cpu.*reg.field = static_cast<int64_t>( reg.dword ? static_cast<uint32_t>( value ) : value );
+    }
+
+    uint64_t micro_address( const x86_cpu& cpu, const micro_op& op ) {
+    	uint64_t address = static_cast<uint64_t>( op.value );
+    	if ( op.base.field ) {
+    		address += read_register( cpu, op.base );
     	}
-    	auto res = get_function_str( file, function_name );
-    	if ( !res ) {
-    		return std::unexpected( "Failed to Extract Function String from File" );
+    	if ( op.index.field ) {
+    		address += read_register( cpu, op.index ) * op.scale;
+    	}
+    	return address;
+    }
+
+    micro_op lower_micro_op( const x86_instruction& instruction ) {
+    	micro_op op;
+    	const auto& mnemonic = instruction.mnemonic;
+    	switch ( mnemonic ) {
+    		case x86_mnemonic::endbr64:
+    		case x86_mnemonic::nop:
+    		case x86_mnemonic::nopl:
+    		case x86_mnemonic::nopw:
+    		case x86_mnemonic::padding:
+    			op.opcode = micro_opcode::nop;
+    			return op;
+    		default:
+    			break;
+    	}
+    	if ( !instruction.operands ) {
+    		return op;
     	}
-    	auto& str = res.value();
-    	auto parse_result = parse_function( str );
-    	if ( !parse_result ) {
-    		return std::unexpected( parse_result.error() );
+    	const auto& operands = instruction.operands.value();
+    	auto reg = [ & ]( std::size_t i ) -> micro_register {
+    		const auto* r = i < operands.size() ? std::get_if<x86_register>( &operands[ i ] ) : nullptr;
+    		return r ? resolve_register( *r ) : micro_register{};
+    	};
+    	auto immediate = [ & ]( std::size_t i ) -> const x86_immediate* {
+    		return i < operands.size() ? std::get_if<x86_immediate>( &operands[ i ] ) : nullptr;
+    	};
+    	// Fills base, index, scale and value; rip-relative operands become absolute.
+    	auto memory = [ & ]( std::size_t i ) -> bool {
+    		const auto* m = i < operands.size() ? std::get_if<x86_memory>( &operands[ i ] ) : nullptr;
+    		if ( m == nullptr ) {
+    			return false;
+    		}
+    		op.value = m->displacement.value_or( 0 );
+    		if ( m->base == x86_register::rip ) {
+    			op.value += static_cast<int64_t>( instruction.address + instruction.machine_bytes.size() );
+    		} else if ( m->base ) {
+    			op.base = resolve_register( m->base.value() );
+    			if ( !op.base.field ) {
+    				return false;
+    			}
+    		}
+    		if ( m->index ) {
+    			op.index = resolve_register( m->index.value() );
+    			op.scale = m->scale.value_or( 1 );
+    			if ( !op.index.field ) {
+    				return false;
+    			}
+    		}
+    		return true;
+    	};
+    	auto lowered = [ & ]( micro_opcode opcode ) {
+    		op.opcode = opcode;
+    		return op;
+    	};
+
+    	switch ( mnemonic ) {
+    		case x86_mnemonic::mov: {
+    			if ( operands.size() != 2 ) {
+    				break;
+    			}
+    			if ( ( op.dst = reg( 1 ) ).field ) {
+    				if ( ( op.src = reg( 0 ) ).field ) {
+    					return lowered( micro_opcode::mov_rr );
+    				}
+    				if ( const auto* imm = immediate( 0 ) ) {
+    					op.value = imm->value;
+    					return lowered( micro_opcode::mov_ri );
+    				}
+    				if ( memory( 0 ) ) {
+    					op.size = op.dst.dword ? 4 : 8;
+    					return lowered( micro_opcode::mov_rm );
+    				}
+    			} else if ( ( op.src = reg( 0 ) ).field && memory( 1 ) ) {
+    				op.size = op.src.dword ? 4 : 8;
+    				return lowered( micro_opcode::mov_mr );
+    			}
+    			break;
+    		}
+    		case x86_mnemonic::add:
+    			if ( operands.size() == 2 && immediate( 0 ) && ( op.dst = reg( 1 ) ).field ) {
+    				op.value = immediate( 0 )->value;
+    				return lowered( micro_opcode::add_ri );
+    			}
+    			break;
+    		case x86_mnemonic::and_:
+    			if ( operands.size() == 2 && ( op.dst = reg( 1 ) ).field ) {
+    				if ( const auto* imm = immediate( 0 ) ) {
+    					op.value = imm->value;
+    					return lowered( micro_opcode::and_ri );
+    				}
+    				if ( ( op.src = reg( 0 ) ).field ) {
+    					return lowered( micro_opcode::and_rr );
+    				}
+    			}
+    			break;
+    		// cmp, test and xor take operands[ 0 ] as dst, as their handlers do.
+    		case x86_mnemonic::cmp:
+    		case x86_mnemonic::test:
+    		case x86_mnemonic::xor_:
+    			if ( operands.size() == 2 && ( op.dst = reg( 0 ) ).field && ( op.src = reg( 1 ) ).field ) {
+    				return lowered( mnemonic == x86_mnemonic::cmp ? micro_opcode::cmp_rr :
+    								mnemonic == x86_mnemonic::test ? micro_opcode::test_rr : micro_opcode::xor_rr );
+    			}
+    			break;
+    		case x86_mnemonic::lea: {
+    			// execute_lea reads only base and displacement, and rip as it stands.
+    			const auto* m = std::get_if<x86_memory>( &operands[ 0 ] );
+    			if ( operands.size() == 2 && m && m->base && m->base != x86_register::rip && m->displacement && !m->index &&
+    				 ( op.dst = reg( 1 ) ).field && memory( 0 ) ) {
+    				return lowered( micro_opcode::lea );
+    			}
+    			break;
+    		}
+    		case x86_mnemonic::jmp:
+    		case x86_mnemonic::je:
+    		case x86_mnemonic::jne:
+    			if ( operands.size() == 1 && std::holds_alternative<x86_address>( operands[ 0 ] ) ) {
+    				op.value = static_cast<int64_t>( std::get<x86_address>( operands[ 0 ] ).addr );
+    				return lowered( mnemonic == x86_mnemonic::jmp ? micro_opcode::jmp :
+    								mnemonic == x86_mnemonic::je ? micro_opcode::je : micro_opcode::jne );
+    			}
+    			break;
+    		default:
+    			break;
     	}
-    	return parse_result.value();
+    	return micro_op{};
     }
 
-    // ========================
-    //  Extract Function Names
-    // ========================
+    std::expected<dispatch_table,std::string> lower_program( const program& prog ) {
+    	dispatch_table table;
+    	if ( prog.instrs.empty() ) {
+    		return table;
+    	}
+    	std::vector<const x86_instruction*> ordered;
+    	ordered.reserve( prog.instrs.size() );
+    	for ( const auto& [ address, instruction ] : prog.instrs ) {
+    		if ( address != instruction.address ) {
+    			return std::unexpected( "Instruction stored under the wrong Address" );
+    		}
+    		ordered.push_back( &instruction );
+    	}
+    	std::sort( ordered.begin(), ordered.end(), []( const x86_instruction* lhs, const x86_instruction* rhs ) {
+    		return lhs->address < rhs->address;
+    	} );
+    	table.base = ordered.front()->address;
+    	uint64_t span = ordered.back()->address - table.base + 1;
+    	if ( span > dispatch_table::max_span ) {
+    		return std::unexpected( "Program spans too many Bytes" );
+    	}
+    	table.step_at.assign( span, dispatch_table::no_step );
+    	table.steps.reserve( ordered.size() );
+    	for ( const auto* instruction : ordered ) {
+    		table.step_at[ instruction->address - table.base ] = static_cast<uint32_t>( table.steps.size() );
+    		table.steps.push_back( { instruction, get_instruction_handler( instruction->mnemonic ),
+    								 instruction->address + instruction->machine_bytes.size(), dispatch_table::no_step,
+    								 sets_rip( instruction->mnemonic ) } );
+    	}
+    	for ( auto& step : table.steps ) {
+    		step.next = table.find( step.fall_through );
+    		step.op = lower_micro_op( *step.instruction );
+    		switch ( step.op.opcode ) {
+    			case micro_opcode::jmp:
+    			case micro_opcode::je:
+    			case micro_opcode::jne:
+    				step.op.target = table.find( static_cast<uint64_t>( step.op.value ) );
+    				break;
+    			default:
+    				break;
+    		}
+    	}
+    	return table;
+    }
 
-    std::expected<std::vector<std::string>,std::string> extract_function_names( const std::string& file_name ) {
-    	std::vector<std::string> result;
-    	std::ifstream file( file_name );
-    	if ( !file ) {
-    		return std::unexpected( "Failed to Open File" );
+    // The interpreter's inner loop; forced inline so run's loops keep the dispatch local.
+    __attribute__((always_inline)) inline std::expected<void,std::string> execute_micro_op( x86_vm& vm, const dispatch_step& step ) {
+    	const auto& op = step.op;
+    	switch ( op.opcode ) {
+    		case micro_opcode::generic:
+    			if ( auto result = step.handler( vm, *step.instruction ); !result ) {
+    				return std::unexpected( result.error() );
+    			}
+    			if ( step.branches ) {
+    				return {};
+    			}
+    			break;
+    		case micro_opcode::nop:
+    			break;
+    		case micro_opcode::mov_rr:
+    			write_register( vm.cpu, op.dst, read_register( vm.cpu, op.src ) );
+    			break;
+    		case micro_opcode::mov_ri:
+    			write_register( vm.cpu, op.dst, static_cast<uint64_t>( op.value ) );
+    			break;
+    		case micro_opcode::mov_rm: {
+    			auto value = vm.memory.load( micro_address( vm.cpu, op ), op.size );
+    			if ( !value ) {
+    				return std::unexpected( value.error() );
+    			}
+    			write_register( vm.cpu, op.dst, value.value() );
+    			break;
+    		}
+    		case micro_opcode::mov_mr:
+    			if ( auto result = vm.memory.store( micro_address( vm.cpu, op ), read_register( vm.cpu, op.src ), op.size ); !result ) {
+    				return std::unexpected( result.error() );
+    			}
+    			break;
+    		case micro_opcode::add_ri:
+    			write_register( vm.cpu, op.dst, read_register( vm.cpu, op.dst ) + static_cast<uint64_t>( op.value ) );
+    			break;
+    		case micro_opcode::and_ri:
+    		case micro_opcode::and_rr: {
+    			uint64_t result = read_register( vm.cpu, op.dst ) &
+    							  ( op.opcode == micro_opcode::and_ri ? static_cast<uint64_t>( op.value ) : read_register( vm.cpu, op.src ) );
+    			vm.cpu.zero_flag = ( result == 0 );
+    			vm.cpu.sign_flag = ( result >> 63 ) & 1;
+    			vm.cpu.carry_flag = false;
+    			vm.cpu.overflow_flag = false;
+    			write_register( vm.cpu, op.dst, result );
+    			break;
+    		}
+    		case micro_opcode::cmp_rr: {
+    			uint64_t lhs = read_register( vm.cpu, op.dst );
+    			uint64_t rhs = read_register( vm.cpu, op.src );
+    			int64_t signed_diff = static_cast<int64_t>( lhs ) - static_cast<int64_t>( rhs );
+    			vm.cpu.zero_flag = ( signed_diff == 0 );
+    			vm.cpu.sign_flag = ( signed_diff < 0 );
+    			vm.cpu.carry_flag = ( lhs < rhs );
+    			vm.cpu.overflow_flag = ( ( lhs ^ rhs ) & ( lhs ^ signed_diff ) ) >> 63;
+    			break;
+    		}
+    		case micro_opcode::test_rr: {
+    			uint64_t result = read_register( vm.cpu, op.dst ) & read_register( vm.cpu, op.src );
+    			vm.cpu.zero_flag = ( result == 0 );
+    			vm.cpu.sign_flag = ( result >> 63 ) & 1;
+    			vm.cpu.carry_flag = false;
+    			vm.cpu.overflow_flag = false;
+    			break;
+    		}
+    		case micro_opcode::xor_rr:
+    			write_register( vm.cpu, op.dst, read_register( vm.cpu, op.dst ) ^ read_register( vm.cpu, op.src ) );
+    			break;
+    		case micro_opcode::lea:
+    			write_register( vm.cpu, op.dst, micro_address( vm.cpu, op ) );
+    			break;
+    		case micro_opcode::je:
+    		case micro_opcode::jne:
+    			if ( vm.cpu.zero_flag != ( op.opcode == micro_opcode::je ) ) {
+    				break;
+    			}
+    			[[fallthrough]];
+    		case micro_opcode::jmp:
+    			vm.cpu.rip = op.value;
+    			return {};
     	}
-    	std::string line;
-    	std::smatch match;
-    	while ( std::getline( file, line ) ) {
-    		if ( std::regex_search( line, match, func_name_regex ) ) {
-    			result.push_back( match[ 1 ].str() );
+    	vm.cpu.rip = static_cast<int64_t>( step.fall_through );
+    	return {};
+    }
+
+    std::expected<void,std::string> x86_vm::execute_step( const dispatch_step& step ) {
+    	return execute_micro_op( *this, step );
+    }
+
+    std::string no_instruction( uint64_t address ) {
+    	std::ostringstream message;
+    	message << "No Instruction at 0x" << std::hex << address;
+    	return message.str();
+    }
+
+    std::expected<uint32_t,std::string> x86_vm::run( const dispatch_table& table, uint64_t entry_point, uint64_t exit_point ) {
+    	cpu.rip = static_cast<int64_t>( entry_point );
+    	uint32_t current = table.find( entry_point );
+    	while ( static_cast<uint64_t>( cpu.rip ) != exit_point ) {
+    		if ( current == dispatch_table::no_step ) {
+    			return std::unexpected( no_instruction( static_cast<uint64_t>( cpu.rip ) ) );
+    		}
+    		const auto& step = table.steps[ current ];
+    		if ( auto result = execute_micro_op( *this, step ); !result ) {
+    			return std::unexpected( result.error() );
+    		}
+    		if ( static_cast<uint64_t>( cpu.rip ) == step.fall_through ) {
+    			current = step.next;
+    		} else if ( step.op.opcode != micro_opcode::generic ) {
+    			current = step.op.target;
+    		} else {
+    			current = table.find( static_cast<uint64_t>( cpu.rip ) );
     		}
     	}
-    	return result;
+    	return static_cast<uint32_t>( cpu.rax );
     }
 
-    // ================
-    //  Get Elf Header
-    // ================
+    // =====
+    //  Jit
+    // =====
 
-    std::expected<elf64_ehdr,std::string> get_elf_header( const std::string& file_name ) {
-		std::ifstream file( file_name, std::ios::binary );
-		if ( !file ) {
-			std::unexpected( "Failed to Open File" );
-		}		
-		std::vector<unsigned char> buffer( 64 );
-		file.read( reinterpret_cast<char*>( buffer.data() ), buffer.size() );
-		elf64_ehdr hdr;
-		std::memcpy( &hdr, buffer.data(), sizeof(hdr) );
-	    file.seekg(0, std::ios::end);
-		auto filesize = file.tellg();
-	    return hdr;
-	}
+    jit_memory::jit_memory( jit_memory&& other ) noexcept : chunks( std::move( other.chunks ) ) {
+    	other.chunks.clear();
+    }
 
-	// ==================
-    //  Parse Elf64 Shdr
-    // ==================
+    jit_memory& jit_memory::operator=( jit_memory&& other ) noexcept {
+    	if ( this != &other ) {
+    		for ( auto& chunk : chunks ) {
+    			::munmap( chunk.data, chunk_size );
+    		}
+    		chunks = std::move( other.chunks );
+    		other.chunks.clear();
+    	}
+    	return *this;
+    }
 
-	std::expected<std::vector<elf64_shdr>,std::string> parse_elf64_shdr( std::ifstream& file, elf64_ehdr& hdr ) {
-		std::vector<elf64_shdr> sections( hdr.e_shnum );
-		file.seekg( hdr.e_shoff );
-		for ( std::size_t i = 0; i < hdr.e_shnum; ++i ) {
-			file.read( reinterpret_cast<char*>( &sections[ i ] ), sizeof( elf64_shdr ) );
-			if ( !file ) {
-        		return std::unexpected( "Failed to Read Section Header" );
+    jit_memory::~jit_memory() {
+    	for ( auto& chunk : chunks ) {
+    		::munmap( chunk.data, chunk_size );
+    	}
+    }
+
+    const uint8_t* jit_memory::add( std::span<const uint8_t> code ) {
+    	if ( code.size() > chunk_size ) {
+    		return nullptr;
+    	}
+    	if ( chunks.empty() || chunk_size - chunks.back().used < code.size() ) {
+    		void* data = ::mmap( nullptr, chunk_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0 );
+    		if ( data == MAP_FAILED ) {
+    			return nullptr;
     		}
-		}
-		elf64_shdr shstr = sections[ hdr.e_shstrndx ];
-		std::vector<char> shshrtab( shstr.sh_size );
-		file.seekg( shstr.sh_offset );
-		file.read( shshrtab.data(), shshrtab.size() );
+    		chunks.push_back( { static_cast<uint8_t*>( data ), 0 } );
+    	} else if ( ::mprotect( chunks.back().data, chunk_size, PROT_READ | PROT_WRITE ) != 0 ) {
+    		return nullptr;
+    	}
+    	auto& chunk = chunks.back();
+    	uint8_t* entry = chunk.data + chunk.used;
+    	std::memcpy( entry, code.data(), code.size() );
+    	chunk.used += ( code.size() + 15 ) & ~std::size_t{ 15 };
+    	if ( ::mprotect( chunk.data, chunk_size, PROT_READ | PROT_EXEC ) != 0 ) {
+    		return nullptr;
+    	}
+    	return entry;
+    }
 
-		for ( std::size_t i = 0; i < hdr.e_shnum; ++i ) {
-			const char* name = &shshrtab[ sections[ i ].sh_name ];
-		}
-		return sections;
-	}
+    // Offset of an x86_cpu field, for addressing it from the cpu pointer in rdi.
+    template<typename T>
+    int32_t cpu_offset( T x86_cpu::* field ) {
+    	static const x86_cpu probe{};
+    	return static_cast<int32_t>( reinterpret_cast<const char*>( &( probe.*field ) ) - reinterpret_cast<const char*>( &probe ) );
+    }
 
-	// =======================
-    //  Parse x86 Instruction
-    // =======================
+    // Emits the handful of host instructions the templates need. Guest registers stay in
+    // their x86_cpu fields; rax and rcx are scratch, rdi holds the cpu and rsi the counter.
+    struct jit_emitter {
+    	enum host_register : uint8_t { rax = 0, rcx = 1 };
+    	enum condition : uint8_t { overflow = 0x0, below = 0x2, equal = 0x4, not_equal = 0x5, sign = 0x8 };
 
-	std::expected<x86_instruction,std::string> parse_x86_instruction( std::span<const uint8_t> bytes ) {
-		x86_instruction res;
-		std::size_t pos{};
-		bool rex_present = ( bytes[ 0 ] & 0xf0 ) == 0x40;
-		uint8_t rex;
-		if ( rex_present ) {
-			rex = bytes[ 0 ];
-			pos++;
-		}
-		uint8_t opcode = bytes[ pos++ ];
-		uint8_t modrm = bytes[ pos++ ];
-    	uint8_t mod = ( modrm & 0b11000000 ) >> 6;
-    	uint8_t reg_opcode = ( modrm & 0b00111000 ) >> 3; 
-    	uint8_t rm = modrm & 0b00000111;
-
-    	switch ( reg_opcode ) {
-    		case 5: { 
-    			res.mnemonic = x86_mnemonic::sub; 
-    			break;
+    	std::vector<uint8_t> code;
+
+    	void emit( std::initializer_list<uint8_t> bytes ) {
+    		code.insert( code.end(), bytes );
+    	}
+
+    	void emit32( int32_t value ) {
+    		uint8_t bytes[ 4 ];
+    		std::memcpy( bytes, &value, sizeof( value ) );
+    		code.insert( code.end(), bytes, bytes + 4 );
+    	}
+
+    	void emit64( uint64_t value ) {
+    		uint8_t bytes[ 8 ];
+    		std::memcpy( bytes, &value, sizeof( value ) );
+    		code.insert( code.end(), bytes, bytes + 8 );
+    	}
+
+    	// mov reg, [rdi + field], 32-bit loads zero-extending like read_register.
+    	void load( host_register reg, const micro_register& field ) {
+    		if ( !field.dword ) {
+    			emit( { 0x48 } );
     		}
-    		default:
-    			return std::unexpected( "Unrecognised Reg Opcode" ); 
+    		emit( { 0x8b, static_cast<uint8_t>( 0x87 | reg << 3 ) } );
+    		emit32( cpu_offset( field.field ) );
     	}
 
-    	x86_register dst;
-    	switch ( rm ) {
-    		case 4: { 
-    			dst = x86_register::rsp; 
-    			break;
+    	// mov [rdi + field], rax, truncating first for dword views like write_register.
+    	void store_rax( const micro_register& field ) {
+    		if ( field.dword ) {
+    			emit( { 0x89, 0xc0 } );
     		}
-    		default: 
-    			return std::unexpected( "Unrecognised Dst" );
+    		emit( { 0x48, 0x89, 0x87 } );
+    		emit32( cpu_offset( field.field ) );
+    	}
+
+    	void move_immediate( host_register reg, uint64_t value ) {
+    		emit( { 0x48, static_cast<uint8_t>( 0xb8 + reg ) } );
+    		emit64( value );
     	}
 
-    	uint8_t imm = bytes[ pos++ ];
-    	res.operands = std::vector<x86_operand>{ dst, x86_immediate( imm ) };
-    	return res;
+    	// op rax, rcx for the r/m64, r64 forms: add 01, and 21, xor 31, cmp 39, test 85.
+    	void alu( uint8_t opcode ) {
+    		emit( { 0x48, opcode, 0xc8 } );
+    	}
+
+    	void set_flag( condition cc, bool x86_cpu::* flag ) {
+    		emit( { 0x0f, static_cast<uint8_t>( 0x90 | cc ), 0x87 } );
+    		emit32( cpu_offset( flag ) );
+    	}
+
+    	void clear_flag( bool x86_cpu::* flag ) {
+    		emit( { 0xc6, 0x87 } );
+    		emit32( cpu_offset( flag ) );
+    		emit( { 0x00 } );
+    	}
+
+    	// Zero, sign and cleared carry and overflow, as execute_and and execute_test set them.
+    	void logic_flags() {
+    		set_flag( equal, &x86_cpu::zero_flag );
+    		set_flag( sign, &x86_cpu::sign_flag );
+    		clear_flag( &x86_cpu::carry_flag );
+    		clear_flag( &x86_cpu::overflow_flag );
+    	}
+
+    	// cmp byte [rdi + zero_flag], 0
+    	void test_zero_flag() {
+    		emit( { 0x80, 0xbf } );
+    		emit32( cpu_offset( &x86_cpu::zero_flag ) );
+    		emit( { 0x00 } );
+    	}
+
+    	void address( const micro_op& op ) {
+    		move_immediate( rax, static_cast<uint64_t>( op.value ) );
+    		if ( op.base.field ) {
+    			load( rcx, op.base );
+    			alu( 0x01 );
+    		}
+    		if ( op.index.field ) {
+    			load( rcx, op.index );
+    			if ( op.scale > 1 ) {
+    				emit( { 0x48, 0xc1, 0xe1, static_cast<uint8_t>( std::countr_zero( op.scale ) ) } );
+    			}
+    			alu( 0x01 );
+    		}
+    	}
+
+    	void return_rip( uint64_t rip ) {
+    		move_immediate( rax, rip );
+    		emit( { 0xc3 } );
+    	}
+    };
+
+    std::optional<std::vector<uint8_t>> compile_block( const dispatch_table& table, const basic_block& block ) {
+    	jit_emitter e;
+    	uint64_t start = table.steps[ block.first ].instruction->address;
+    	std::size_t top = 0;
+    	e.emit( { 0x48, 0xff, 0x06 } );  // inc qword [rsi]
+    	for ( uint32_t i = block.first; i <= block.last; ++i ) {
+    		const auto& step = table.steps[ i ];
+    		const auto& op = step.op;
+    		switch ( op.opcode ) {
+    			case micro_opcode::nop:
+    				break;
+    			case micro_opcode::mov_rr:
+    				e.load( jit_emitter::rax, op.src );
+    				e.store_rax( op.dst );
+    				break;
+    			case micro_opcode::mov_ri:
+    				e.move_immediate( jit_emitter::rax, static_cast<uint64_t>( op.value ) );
+    				e.store_rax( op.dst );
+    				break;
+    			case micro_opcode::add_ri:
+    				e.load( jit_emitter::rax, op.dst );
+    				e.move_immediate( jit_emitter::rcx, static_cast<uint64_t>( op.value ) );
+    				e.alu( 0x01 );
+    				e.store_rax( op.dst );
+    				break;
+    			case micro_opcode::and_ri:
+    			case micro_opcode::and_rr:
+    				e.load( jit_emitter::rax, op.dst );
+    				if ( op.opcode == micro_opcode::and_ri ) {
+    					e.move_immediate( jit_emitter::rcx, static_cast<uint64_t>( op.value ) );
+    				} else {
+    					e.load( jit_emitter::rcx, op.src );
+    				}
+    				e.alu( 0x21 );
+    				e.logic_flags();
+    				e.store_rax( op.dst );
+    				break;
+    			case micro_opcode::cmp_rr:
+    				e.load( jit_emitter::rax, op.dst );
+    				e.load( jit_emitter::rcx, op.src );
+    				e.alu( 0x39 );
+    				e.set_flag( jit_emitter::equal, &x86_cpu::zero_flag );
+    				e.set_flag( jit_emitter::sign, &x86_cpu::sign_flag );
+    				e.set_flag( jit_emitter::below, &x86_cpu::carry_flag );
+    				e.set_flag( jit_emitter::overflow, &x86_cpu::overflow_flag );
+    				break;
+    			case micro_opcode::test_rr:
+    				e.load( jit_emitter::rax, op.dst );
+    				e.load( jit_emitter::rcx, op.src );
+    				e.alu( 0x85 );
+    				e.logic_flags();
+    				break;
+    			case micro_opcode::xor_rr:
+    				e.load( jit_emitter::rax, op.dst );
+    				e.load( jit_emitter::rcx, op.src );
+    				e.alu( 0x31 );
+    				e.store_rax( op.dst );
+    				break;
+    			case micro_opcode::lea:
+    				e.address( op );
+    				e.store_rax( op.dst );
+    				break;
+    			case micro_opcode::jmp:
+    				e.return_rip( static_cast<uint64_t>( op.value ) );
+    				return e.code;
+    			case micro_opcode::je:
+    			case micro_opcode::jne: {
+    				bool je = op.opcode == micro_opcode::je;
+    				auto target = static_cast<uint64_t>( op.value );
+    				if ( target == start ) {
+    					// Loop natively while the branch is taken, counting each pass.
+    					e.test_zero_flag();
+    					e.emit( { 0x0f, static_cast<uint8_t>( 0x80 | ( je ? jit_emitter::not_equal : jit_emitter::equal ) ) } );
+    					e.emit32( static_cast<int32_t>( top ) - static_cast<int32_t>( e.code.size() + 4 ) );
+    					e.return_rip( step.fall_through );
+    					return e.code;
+    				}
+    				e.move_immediate( jit_emitter::rax, step.fall_through );
+    				e.move_immediate( jit_emitter::rcx, target );
+    				e.test_zero_flag();
+    				// cmovne / cmove rax, rcx
+    				e.emit( { 0x48, 0x0f, static_cast<uint8_t>( 0x40 | ( je ? jit_emitter::not_equal : jit_emitter::equal ) ), 0xc1 } );
+    				e.emit( { 0xc3 } );
+    				return e.code;
+    			}
+    			default:
+    				return std::nullopt;
+    		}
+    	}
+    	e.return_rip( table.steps[ block.last ].fall_through );
+    	return e.code;
+    }
+
+    bool same_registers( const x86_cpu& lhs, const x86_cpu& rhs ) {
+    	return lhs.rax == rhs.rax && lhs.rbp == rhs.rbp && lhs.rdi == rhs.rdi && lhs.rdx == rhs.rdx && lhs.rip == rhs.rip &&
+    		   lhs.rsi == rhs.rsi && lhs.rsp == rhs.rsp && lhs.r8 == rhs.r8 && lhs.r9 == rhs.r9 && lhs.r10 == rhs.r10 &&
+    		   lhs.r11 == rhs.r11 && lhs.r12 == rhs.r12 && lhs.r13 == rhs.r13 && lhs.r14 == rhs.r14 && lhs.r15 == rhs.r15 &&
+    		   lhs.zero_flag == rhs.zero_flag && lhs.carry_flag == rhs.carry_flag && lhs.sign_flag == rhs.sign_flag &&
+    		   lhs.overflow_flag == rhs.overflow_flag;
+    }
+
+    // =============
+    //  Block Cache
+    // =============
+
+    basic_block* block_cache::find( uint64_t address ) {
+    	if ( auto it = blocks.find( address ); it != blocks.end() ) {
+    		return &it->second;
+    	}
+    	uint32_t first = table->find( address );
+    	if ( first == dispatch_table::no_step ) {
+    		return nullptr;
+    	}
+    	// A block runs until a branch, a gap, or the exit point.
+    	uint32_t last = first;
+    	while ( !table->steps[ last ].branches && table->steps[ last ].next != dispatch_table::no_step &&
+    			table->steps[ last ].fall_through != exit_point ) {
+    		last = table->steps[ last ].next;
+    	}
+    	basic_block block;
+    	block.first = first;
+    	block.last = last;
+    	return &blocks.emplace( address, block ).first->second;
+    }
+
+    std::expected<uint32_t,std::string> x86_vm::run( block_cache& cache, uint64_t entry_point ) {
+    	const dispatch_step* steps = cache.table->steps.data();
+    	const uint64_t exit_point = cache.exit_point;
+    	cpu.rip = static_cast<int64_t>( entry_point );
+    	basic_block* block = cache.find( entry_point );
+    	while ( static_cast<uint64_t>( cpu.rip ) != exit_point ) {
+    		if ( block == nullptr ) {
+    			return std::unexpected( no_instruction( static_cast<uint64_t>( cpu.rip ) ) );
+    		}
+    		if ( block->compiled ) {
+    			if ( cache.verify_jit ) {
+    				// Replays the block on a copy, looping as the compiled code does.
+    				x86_vm interpreted;
+    				interpreted.cpu = cpu;
+    				uint64_t start = static_cast<uint64_t>( cpu.rip );
+    				do {
+    					for ( const auto* step = steps + block->first; step <= steps + block->last; ++step ) {
+    						if ( auto result = execute_micro_op( interpreted, *step ); !result ) {
+    							return std::unexpected( result.error() );
+    						}
+    					}
+    				} while ( static_cast<uint64_t>( interpreted.cpu.rip ) == start && steps[ block->last ].op.opcode != micro_opcode::jmp );
+    				cpu.rip = static_cast<int64_t>( block->compiled( &cpu, &block->executions ) );
+    				if ( !same_registers( cpu, interpreted.cpu ) ) {
+    					std::ostringstream message;
+    					message << "JIT Mismatch in Block at 0x" << std::hex << start;
+    					return std::unexpected( message.str() );
+    				}
+    			} else {
+    				cpu.rip = static_cast<int64_t>( block->compiled( &cpu, &block->executions ) );
+    			}
+    		} else {
+    			++block->executions;
+    			for ( const auto* step = steps + block->first; step <= steps + block->last; ++step ) {
+    				if ( auto result = execute_micro_op( *this, *step ); !result ) {
+    					return std::unexpected( result.error() );
+    				}
+    			}
+    			if ( cache.jit_threshold != 0 && block->executions >= cache.jit_threshold && !block->uncompilable ) {
+    				auto code = compile_block( *cache.table, *block );
+    				const uint8_t* entry = code ? cache.jit.add( code.value() ) : nullptr;
+    				if ( entry ) {
+    					block->compiled = reinterpret_cast<basic_block::compiled_code>( const_cast<uint8_t*>( entry ) );
+    				} else {
+    					block->uncompilable = true;
+    				}
+    			}
+    		}
+    		// Follow the chained successor. A miss looks the block up once and links it; an
+    		// indirect branch that changes target replaces the link, an inline cache of one.
+    		auto next = static_cast<uint64_t>( cpu.rip );
+    		auto& exits = block->exits;
+    		if ( exits[ 0 ].address == next && exits[ 0 ].block ) {
+    			block = exits[ 0 ].block;
+    		} else if ( exits[ 1 ].address == next && exits[ 1 ].block ) {
+    			block = exits[ 1 ].block;
+    		} else if ( next != exit_point ) {
+    			bool falls_through = next == steps[ block->last ].fall_through;
+    			block = cache.find( next );
+    			exits[ falls_through ? 0 : 1 ] = { next, block };
+    		}
+    	}
+    	return static_cast<uint32_t>( cpu.rax );
+    }
+
+    std::expected<uint32_t,std::string> x86_vm::load_program( const program& prog ) {
+    	auto table = lower_program( prog );
+    	if ( !table ) {
+    		return std::unexpected( table.error() );
+    	}
+    	block_cache cache{ &table.value(), prog.exit_point };
+    	return run( cache, prog.entry_point );
+    }
+
+    // ==========
+    //  Map File
+    // ==========
+
+    mapped_file::mapped_file( mapped_file&& other ) noexcept
+    	: data( std::exchange( other.data, nullptr ) ), size( std::exchange( other.size, 0 ) ) {}
+
+    mapped_file& mapped_file::operator=( mapped_file&& other ) noexcept {
+    	if ( this != &other ) {
+    		if ( data ) {
+    			::munmap( const_cast<char*>( data ), size );
+    		}
+    		data = std::exchange( other.data, nullptr );
+    		size = std::exchange( other.size, 0 );
+    	}
+    	return *this;
+    }
+
+    mapped_file::~mapped_file() {
+    	if ( data ) {
+    		::munmap( const_cast<char*>( data ), size );
+    	}
+    }
+
+    std::expected<mapped_file,std::string> map_file( const std::string& file_name, map_advice advice ) {
+    	int fd = ::open( file_name.c_str(), O_RDONLY | O_CLOEXEC );
+    	if ( fd == -1 ) {
+    		return std::unexpected( "Failed to Open File" );
+    	}
+    	struct stat st{};
+    	if ( ::fstat( fd, &st ) == -1 ) {
+    		::close( fd );
+    		return std::unexpected( "Failed to Stat File" );
+    	}
+    	mapped_file result;
+    	if ( st.st_size == 0 ) {
+    		::close( fd );
+    		return result;
+    	}
+    	void* addr = ::mmap( nullptr, static_cast<std::size_t>( st.st_size ), PROT_READ, MAP_PRIVATE, fd, 0 );
+    	::close( fd );
+    	if ( addr == MAP_FAILED ) {
+    		return std::unexpected( "Failed to Map File" );
+    	}
+    	result.data = static_cast<const char*>( addr );
+    	result.size = static_cast<std::size_t>( st.st_size );
+    	switch ( advice ) {
+    		case map_advice::sequential:
+    			::madvise( addr, result.size, MADV_SEQUENTIAL );
+    			break;
+    		case map_advice::random:
+    			::madvise( addr, result.size, MADV_RANDOM );
+    			break;
+    		case map_advice::normal:
+    			break;
+    	}
+    	return result;
+    }
+
+    // =======================
+    //  Get Empty Line Offset
+    // =======================
+
+    int get_empty_line_offset( std::ifstream& file, std::size_t start_line ) {
+    	std::streampos original_pos = file.tellg();
+    	file.clear();
+    	file.seekg(0);
+    	std::string line;
+    	std::size_t current = 0;
+    	while ( current < start_line && std::getline( file, line ) ) {
+    		++current;	
+    	}
+    	if ( current != start_line ) {
+    		file.clear();
+    		file.seekg( original_pos );
+    		return -1;
+    	}
+    	int offset = 0;
+    	while ( std::getline( file, line ) ) {
+    		if ( line.empty() ) {
+    			file.clear();
+    			file.seekg( original_pos );
+    			++offset;
+    			return offset;
+    		}
+    		++offset;
+    	}
+    	file.clear();
+    	file.seekg( original_pos );
+    	return -1;
+    }
+
+    // =======================
+    //  Match Function Header
+    // =======================
+
+    // Matches objdump's "<16 hex digit address> <name>:" header line and returns the name.
+    std::optional<std::string_view> match_function_header( std::string_view line ) {
+    	constexpr std::size_t address_width = 16;
+    	if ( line.size() < address_width + 4 || !is_space( line[ address_width ] ) ) {
+    		return std::nullopt;
+    	}
+    	for ( std::size_t i = 0; i < address_width; ++i ) {
+    		if ( !std::isxdigit( static_cast<unsigned char>( line[ i ] ) ) ) {
+    			return std::nullopt;
+    		}
+    	}
+    	std::size_t pos = address_width + 1;
+    	while ( pos < line.size() && is_space( line[ pos ] ) ) {
+    		++pos;
+    	}
+    	std::size_t end = line.size();
+    	while ( end > pos && is_space( line[ end - 1 ] ) ) {
+    		--end;
+    	}
+    	if ( end - pos < 4 || line[ pos ] != '<' || line[ end - 2 ] != '>' || line[ end - 1 ] != ':' ) {
+    		return std::nullopt;
+    	}
+    	return line.substr( pos + 1, end - pos - 3 );
+    }
+
+    // ===========================
+    //  Get Function Name Line No
+    // ===========================
+
+    std::optional<std::size_t> get_function_name_line_no( std::ifstream& file, const std::string& function_name ) {
+    	std::string line;
+    	std::size_t line_number = 0;
+    	while ( std::getline( file, line ) ) {
+    		++line_number;
+    		auto name = match_function_header( line );
+    		if ( name && name.value() == function_name ) {
+    			return line_number;
+    		}
+    	} 
+    	return std::nullopt;
+    }
+
+    // ==================
+    //  Get Function Str
+    // ==================
+
+    std::expected<std::string,std::string> get_function_str( std::ifstream& file, const std::string& function_name ) {
+    	std::string result;
+    	std::string line;
+    	bool found = false;
+    	while ( std::getline( file, line ) ) {
+    		if ( !found ) {
+    			auto name = match_function_header( line );
+    			if ( name && name.value() == function_name ) {
+    				found = true;
+    				result += line + "\n";
+    			}
+    			continue;
+    		}
+    		if ( line.empty() ) {
+    			break;
+    		}
+    		result += line + "\n";
+    	}
+    	if ( !found ) {
+    		return std::unexpected( "Function Name not found in File" );
+    	}
+    	return result;
+    }
+
+    std::expected<std::string,std::string> get_function_str( std::ifstream& file, const function_location& location ) {
+    	std::string result( location.length, '\0' );
+    	file.clear();
+    	file.seekg( location.offset );
+    	file.read( result.data(), location.length );
+    	if ( !file ) {
+    		return std::unexpected( "Failed to Read Function from File" );
+    	}
+    	return result;
+    }
+
+    // ===================
+    //  Get Function View
+    // ===================
+
+    std::optional<std::string_view> get_function_view( std::string_view text, std::string_view function_name ) {
+    	line_scanner lines( text );
+    	while ( lines.has_next() ) {
+    		std::size_t start = lines.pos;
+    		auto name = match_function_header( lines.next() );
+    		if ( !name || name.value() != function_name ) {
+    			continue;
+    		}
+    		while ( lines.has_next() ) {
+    			std::size_t line_start = lines.pos;
+    			if ( lines.next().empty() ) {
+    				return text.substr( start, line_start - start );
+    			}
+    		}
+    		return text.substr( start );
+    	}
+    	return std::nullopt;
+    }
+
+    // ======================
+    //  Build Function Index
+    // ======================
+
+    std::expected<function_index,std::string> build_function_index( std::ifstream& file ) {
+    	function_index index;
+    	std::string line;
+    	std::size_t offset = 0;
+    	std::optional<std::string> current;
+    	std::size_t current_offset = 0;
+    	file.clear();
+    	file.seekg( 0 );
+    	while ( std::getline( file, line ) ) {
+    		std::size_t line_offset = offset;
+    		offset += line.size() + ( file.eof() ? 0 : 1 );
+    		if ( current ) {
+    			if ( line.empty() ) {
+    				index.try_emplace( std::move( current.value() ), function_location{ current_offset, line_offset - current_offset } );
+    				current.reset();
+    			}
+    			continue;
+    		}
+    		if ( auto name = match_function_header( line ) ) {
+    			current.emplace( name.value() );
+    			current_offset = line_offset;
+    		}
+    	}
+    	if ( current ) {
+    		index.try_emplace( std::move( current.value() ), function_location{ current_offset, offset - current_offset } );
+    	}
+    	file.clear();
+    	return index;
+    }
+
+    std::expected<function_index,std::string> build_function_index( const mapped_file& file ) {
+    	function_index index;
+    	auto text = file.text();
+    	line_scanner lines( text );
+    	while ( lines.has_next() ) {
+    		std::size_t start = lines.pos;
+    		auto name = match_function_header( lines.next() );
+    		if ( !name ) {
+    			continue;
+    		}
+    		std::size_t end = text.size();
+    		while ( lines.has_next() ) {
+    			std::size_t line_start = lines.pos;
+    			if ( lines.next().empty() ) {
+    				end = line_start;
+    				break;
+    			}
+    		}
+    		index.try_emplace( std::string( name.value() ), function_location{ start, end - start } );
+    	}
+    	return index;
+    }
+
+    std::expected<function_index,std::string> build_function_index( const std::string& file_name ) {
+    	auto file = map_file( file_name );
+    	if ( !file ) {
+    		return std::unexpected( file.error() );
+    	}
+    	return build_function_index( file.value() );
+    }
+
+    // ==================
+    //  Extract Function
+    // ==================
+
+    std::expected<function,std::string> extract_function( const std::string& file_name, const std::string& function_name ) {
+    	auto file = map_file( file_name );
+    	if ( !file ) {
+    		return std::unexpected( file.error() );
+    	}
+    	auto body = get_function_view( file->text(), function_name );
+    	if ( !body ) {
+    		return std::unexpected( "Failed to Extract Function String from File" );
+    	}
+    	return parse_function( body.value() );
+    }
+
+    std::expected<function,std::string> extract_function( const mapped_file& file, const function_index& index, const std::string& function_name ) {
+    	auto it = index.find( function_name );
+    	if ( it == index.end() ) {
+    		return std::unexpected( "Function Name not found in Index: " + function_name );
+    	}
+    	auto& location = it->second;
+    	if ( location.offset + location.length > file.size ) {
+    		return std::unexpected( "Function Location outside of File" );
+    	}
+    	return parse_function( file.text().substr( location.offset, location.length ) );
+    }
+
+    std::expected<function,std::string> extract_function( std::ifstream& file, const function_index& index, const std::string& function_name ) {
+    	auto it = index.find( function_name );
+    	if ( it == index.end() ) {
+    		return std::unexpected( "Function Name not found in Index: " + function_name );
+    	}
+    	auto res = get_function_str( file, it->second );
+    	if ( !res ) {
+    		return std::unexpected( res.error() );
+    	}
+    	return parse_function( res.value() );
+    }
+
+    // ===================
+    //  Extract Functions
+    // ===================
+
+    std::expected<std::vector<function>,std::string> extract_functions( const std::string& file_name, const std::vector<std::string>& function_names ) {
+    	auto file = map_file( file_name );
+    	if ( !file ) {
+    		return std::unexpected( file.error() );
+    	}
+    	auto index = build_function_index( file.value() );
+    	if ( !index ) {
+    		return std::unexpected( index.error() );
+    	}
+    	std::vector<function> result;
+    	result.reserve( function_names.size() );
+    	for ( auto& function_name : function_names ) {
+    		auto func = extract_function( file.value(), index.value(), function_name );
+    		if ( !func ) {
+    			return std::unexpected( function_name + ": " + func.error() );
+    		}
+    		result.push_back( std::move( func.value() ) );
+    	}
+    	return result;
+    }
+
+    // =================
+    //  Get Elf Section
+    // =================
+
+    elf_section get_elf_section( std::string_view section_name ) {
+    	if ( section_name == ".init" ) return elf_section::init;
+    	if ( section_name == ".plt" ) return elf_section::plt;
+    	if ( section_name == ".plt.got" ) return elf_section::plt_got;
+    	if ( section_name == ".text" ) return elf_section::text;
+    	if ( section_name == ".fini" ) return elf_section::fini;
+    	return elf_section::unknown;
+    }
+
+    // ===========================
+    //  Parse Section Header View
+    // ===========================
+
+    // Matches "Disassembly of section <name>:" and returns the name.
+    std::optional<std::string_view> parse_section_header_view( std::string_view line ) {
+    	constexpr std::string_view prefix = "Disassembly of section ";
+    	line = trim_view( line );
+    	if ( !line.starts_with( prefix ) || !line.ends_with( ':' ) ) {
+    		return std::nullopt;
+    	}
+    	return line.substr( prefix.size(), line.size() - prefix.size() - 1 );
+    }
+
+    // =================
+    //  Split Functions
+    // =================
+
+    std::vector<function_chunk> split_functions( std::string_view text ) {
+    	std::vector<function_chunk> chunks;
+    	elf_section section = elf_section::unknown;
+    	line_scanner lines( text );
+    	while ( lines.has_next() ) {
+    		std::size_t start = lines.pos;
+    		auto line = lines.next();
+    		if ( auto section_name = parse_section_header_view( line ) ) {
+    			section = get_elf_section( section_name.value() );
+    			continue;
+    		}
+    		if ( !match_function_header( line ) ) {
+    			continue;
+    		}
+    		std::size_t end = text.size();
+    		while ( lines.has_next() ) {
+    			std::size_t line_start = lines.pos;
+    			if ( lines.next().empty() ) {
+    				end = line_start;
+    				break;
+    			}
+    		}
+    		chunks.push_back( { section, text.substr( start, end - start ) } );
+    	}
+    	return chunks;
+    }
+
+    // ========================
+    //  Parse Disassembly Text
+    // ========================
+
+    // Walks the functions of a whole disassembly in file order. on_function( section, name )
+    // returns whether that function's instruction lines should be handed to on_line.
+    template<typename OnFunction, typename OnLine>
+    std::expected<void,std::string> walk_disassembly( std::string_view text, OnFunction on_function, OnLine on_line ) {
+    	elf_section section = elf_section::unknown;
+    	bool in_function = false;
+    	bool wanted = false;
+    	line_scanner lines( text );
+    	while ( lines.has_next() ) {
+    		auto line = lines.next();
+    		if ( in_function ) {
+    			if ( line.empty() ) {
+    				in_function = false;
+    				continue;
+    			}
+    			line = trim_view( line );
+    			if ( !wanted || line.empty() ) {
+    				continue;
+    			}
+    			if ( auto res = on_line( line ); !res ) {
+    				return std::unexpected( res.error() );
+    			}
+    			continue;
+    		}
+    		if ( auto section_name = parse_section_header_view( line ) ) {
+    			section = get_elf_section( section_name.value() );
+    			continue;
+    		}
+    		auto function_name = match_function_header( line );
+    		if ( !function_name ) {
+    			continue;
+    		}
+    		in_function = true;
+    		wanted = on_function( section, function_name.value() );
+    	}
+    	return {};
+    }
+
+    std::expected<elf64_x86_64,std::string> parse_disassembly_text( std::string_view text, std::pmr::memory_resource* resource ) {
+    	elf64_x86_64 result;
+    	function* current = nullptr;
+    	address_range* range = nullptr;
+    	auto walked = walk_disassembly( text, [ & ]( elf_section section, std::string_view name ) {
+    		auto* functions = result.functions( section );
+    		if ( !functions ) {
+    			return false;
+    		}
+    		current = &functions->emplace_back( resource );
+    		current->name = name;
+    		range = result.range( section );
+    		return true;
+    	}, [ & ]( std::string_view line ) -> std::expected<void,std::string> {
+    		auto parse_result = parse_x86_instruction_view( line, resource );
+    		if ( !parse_result ) {
+    			return std::unexpected( parse_result.error() );
+    		}
+    		range->extend( parse_result.value() );
+    		current->instructions.push_back( std::move( parse_result.value() ) );
+    		return {};
+    	} );
+    	if ( !walked ) {
+    		return std::unexpected( walked.error() );
+    	}
+    	return result;
+    }
+
+    // ===============
+    //  Find Function
+    // ===============
+
+    const function* find_function( const elf64_x86_64& elf, uint64_t address ) {
+    	for ( auto section : { elf_section::init, elf_section::plt, elf_section::plt_got, elf_section::text, elf_section::fini } ) {
+    		if ( !elf.range( section )->contains( address ) ) {
+    			continue;
+    		}
+    		auto& functions = *elf.functions( section );
+    		auto it = std::upper_bound( functions.begin(), functions.end(), address, []( uint64_t addr, const function& func ) {
+    			return !func.instructions.empty() && addr < func.instructions.front().address;
+    		} );
+    		while ( it != functions.begin() ) {
+    			--it;
+    			if ( it->instructions.empty() ) {
+    				continue;
+    			}
+    			auto& last = it->instructions.back();
+    			if ( address < last.address + last.machine_bytes.size() ) {
+    				return &*it;
+    			}
+    			break;
+    		}
+    	}
+    	return nullptr;
+    }
+
+    // ===================
+    //  Instruction Store
+    // ===================
+
+    void instruction_store::add_function( std::string_view name, elf_section section ) {
+    	function_offsets.push_back( static_cast<uint32_t>( size() ) );
+    	function_sections.push_back( section );
+    	function_names.emplace_back( name );
+    }
+
+    void instruction_store::push_back( const x86_compact_instruction& instruction ) {
+    	addresses.push_back( instruction.address );
+    	mnemonics.push_back( instruction.mnemonic );
+    	byte_offsets.push_back( static_cast<uint32_t>( bytes.size() ) );
+    	byte_counts.push_back( instruction.byte_count );
+    	auto instruction_bytes = instruction.bytes();
+    	bytes.insert( bytes.end(), instruction_bytes.begin(), instruction_bytes.end() );
+    	operand_offsets.push_back( static_cast<uint32_t>( operand_values.size() ) );
+    	operand_counts.push_back( instruction.operand_count );
+    	for ( std::size_t i = 0; i < instruction.operands_size(); ++i ) {
+    		operand_values.push_back( instruction.values[ i ] );
+    		operand_flags.push_back( instruction.operand_flags[ i ] );
+    		operand_regs.push_back( instruction.regs[ i ] );
+    		operand_indexes.push_back( instruction.indexes[ i ] );
+    		operand_scales.push_back( instruction.scales[ i ] );
+    	}
+    }
+
+    x86_compact_instruction instruction_store::compact( std::size_t i ) const {
+    	x86_compact_instruction result;
+    	result.address = addresses[ i ];
+    	result.mnemonic = mnemonics[ i ];
+    	result.byte_count = byte_counts[ i ];
+    	std::copy_n( bytes.begin() + byte_offsets[ i ], byte_counts[ i ], result.machine_bytes.begin() );
+    	result.operand_count = operand_counts[ i ];
+    	for ( std::size_t slot = 0, j = operand_offsets[ i ]; slot < result.operands_size(); ++slot, ++j ) {
+    		result.values[ slot ] = operand_values[ j ];
+    		result.operand_flags[ slot ] = operand_flags[ j ];
+    		result.regs[ slot ] = operand_regs[ j ];
+    		result.indexes[ slot ] = operand_indexes[ j ];
+    		result.scales[ slot ] = operand_scales[ j ];
+    	}
+    	return result;
+    }
+
+    // Hands each 64 entry block of the mnemonic column to visit as a match bit mask.
+    template<typename Visit>
+    void scan_mnemonics( const std::vector<x86_mnemonic>& mnemonics, x86_mnemonic mnemonic, Visit visit ) {
+    	const char* column = reinterpret_cast<const char*>( mnemonics.data() );
+    	for ( std::size_t block = 0; block < mnemonics.size(); block += 64 ) {
+    		std::size_t n = std::min<std::size_t>( 64, mnemonics.size() - block );
+    		visit( block, match_mask64( column + block, n, static_cast<char>( mnemonic ) ) );
+    	}
+    }
+
+    std::vector<uint32_t> instruction_store::find( x86_mnemonic mnemonic ) const {
+    	std::vector<uint32_t> result;
+    	scan_mnemonics( mnemonics, mnemonic, [ & ]( std::size_t block, uint64_t mask ) {
+    		for ( ; mask; mask &= mask - 1 ) {
+    			result.push_back( static_cast<uint32_t>( block + std::countr_zero( mask ) ) );
+    		}
+    	} );
+    	return result;
+    }
+
+    std::vector<uint64_t> instruction_store::addresses_of( x86_mnemonic mnemonic ) const {
+    	std::vector<uint64_t> result;
+    	scan_mnemonics( mnemonics, mnemonic, [ & ]( std::size_t block, uint64_t mask ) {
+    		for ( ; mask; mask &= mask - 1 ) {
+    			result.push_back( addresses[ block + std::countr_zero( mask ) ] );
+    		}
+    	} );
+    	return result;
+    }
+
+    std::size_t instruction_store::count( x86_mnemonic mnemonic ) const {
+    	std::size_t result = 0;
+    	scan_mnemonics( mnemonics, mnemonic, [ & ]( std::size_t, uint64_t mask ) {
+    		result += std::popcount( mask );
+    	} );
+    	return result;
+    }
+
+    std::expected<instruction_store,std::string> build_instruction_store( const elf64_x86_64& elf ) {
+    	instruction_store store;
+    	for ( auto section : { elf_section::init, elf_section::plt, elf_section::plt_got, elf_section::text, elf_section::fini } ) {
+    		for ( const auto& func : *elf.functions( section ) ) {
+    			store.add_function( func.name, section );
+    			for ( const auto& instruction : func.instructions ) {
+    				auto compact = convert_to_compact( instruction );
+    				if ( !compact ) {
+    					return std::unexpected( compact.error() );
+    				}
+    				store.push_back( compact.value() );
+    			}
+    		}
+    	}
+    	return store;
+    }
+
+    std::expected<instruction_store,std::string> parse_instruction_store( const mapped_file& file ) {
+    	instruction_store store;
+    	auto walked = walk_disassembly( file.text(), [ & ]( elf_section section, std::string_view name ) {
+    		if ( section == elf_section::unknown ) {
+    			return false;
+    		}
+    		store.add_function( name, section );
+    		return true;
+    	}, [ & ]( std::string_view line ) -> std::expected<void,std::string> {
+    		auto instruction = parse_compact_instruction( line );
+    		if ( !instruction ) {
+    			return std::unexpected( instruction.error() );
+    		}
+    		store.push_back( instruction.value() );
+    		return {};
+    	} );
+    	if ( !walked ) {
+    		return std::unexpected( walked.error() );
+    	}
+    	return store;
+    }
+
+    std::expected<instruction_store,std::string> parse_instruction_store( const std::string& file_name ) {
+    	auto file = map_file( file_name );
+    	if ( !file ) {
+    		return std::unexpected( file.error() );
+    	}
+    	return parse_instruction_store( file.value() );
+    }
+
+    // ===================
+    //  Parse Disassembly
+    // ===================
+
+    std::expected<elf64_x86_64,std::string> parse_disassembly( const mapped_file& file, std::size_t thread_count, std::pmr::memory_resource* resource ) {
+    	if ( thread_count == 0 ) {
+    		thread_count = std::max( 1u, std::thread::hardware_concurrency() );
+    	}
+    	if ( thread_count == 1 ) {
+    		return parse_disassembly_text( file.text(), resource );
+    	}
+    	auto chunks = split_functions( file.text() );
+    	std::vector<std::expected<function,std::string>> results( chunks.size(), std::unexpected( std::string() ) );
+    	// Chunks are claimed in file order, so when a worker fails every earlier chunk has
+    	// already been claimed and the first error reported is the first one in the file.
+    	std::atomic<std::size_t> next_chunk{ 0 };
+    	std::atomic<bool> failed{ false };
+    	auto worker = [ & ]() {
+    		while ( !failed.load( std::memory_order_relaxed ) ) {
+    			std::size_t i = next_chunk.fetch_add( 1, std::memory_order_relaxed );
+    			if ( i >= chunks.size() ) {
+    				return;
+    			}
+    			if ( chunks[ i ].section == elf_section::unknown ) {
+    				continue;
+    			}
+    			results[ i ] = parse_function( chunks[ i ].body, resource );
+    			if ( !results[ i ] ) {
+    				failed.store( true, std::memory_order_relaxed );
+    			}
+    		}
+    	};
+    	thread_count = std::min( thread_count, std::max<std::size_t>( chunks.size(), 1 ) );
+    	{
+    		std::vector<std::jthread> threads;
+    		threads.reserve( thread_count - 1 );
+    		for ( std::size_t i = 1; i < thread_count; ++i ) {
+    			threads.emplace_back( worker );
+    		}
+    		worker();
+    	}
+    	elf64_x86_64 result;
+    	for ( std::size_t i = 0; i < chunks.size(); ++i ) {
+    		auto* functions = result.functions( chunks[ i ].section );
+    		if ( !functions ) {
+    			continue;
+    		}
+    		if ( !results[ i ] ) {
+    			return std::unexpected( results[ i ].error() );
+    		}
+    		auto* range = result.range( chunks[ i ].section );
+    		for ( auto& instruction : results[ i ]->instructions ) {
+    			range->extend( instruction );
+    		}
+    		functions->push_back( std::move( results[ i ].value() ) );
+    	}
+    	return result;
+    }
+
+    std::expected<elf64_x86_64,std::string> parse_disassembly( const std::string& file_name, std::size_t thread_count, std::pmr::memory_resource* resource ) {
+    	auto file = map_file( file_name );
+    	if ( !file ) {
+    		return std::unexpected( file.error() );
+    	}
+    	return parse_disassembly( file.value(), thread_count, resource );
+    }
+
+    // ============
+    //  Hash Bytes
+    // ============
+
+    // Four independent multiply-xorshift lanes over 32 byte blocks; fast enough that
+    // hashing the source costs a small fraction of parsing it.
+    uint64_t hash_bytes( std::span<const uint8_t> bytes ) {
+    	constexpr uint64_t k0 = 0x9e3779b97f4a7c15ull;
+    	constexpr uint64_t k1 = 0xff51afd7ed558ccdull;
+    	std::array<uint64_t,4> lanes = { k0, k0 ^ 1, k0 ^ 2, k0 ^ 3 };
+    	std::size_t i = 0;
+    	for ( ; i + 32 <= bytes.size(); i += 32 ) {
+    		for ( std::size_t lane = 0; lane < 4; ++lane ) {
+    			uint64_t word;
+    			std::memcpy( &word, bytes.data() + i + lane * 8, 8 );
+    			lanes[ lane ] = ( lanes[ lane ] ^ word ) * k1;
+    			lanes[ lane ] ^= lanes[ lane ] >> 32;
+    		}
+    	}
+    	uint64_t hash = bytes.size() * k0;
+    	for ( uint64_t lane : lanes ) {
+    		hash = ( hash ^ lane ) * k1;
+    	}
+    	for ( ; i < bytes.size(); i += 8 ) {
+    		uint64_t word = 0;
+    		std::memcpy( &word, bytes.data() + i, std::min<std::size_t>( 8, bytes.size() - i ) );
+    		hash = ( hash ^ word ) * k1;
+    		hash ^= hash >> 32;
+    	}
+    	return hash ^ ( hash >> 29 );
+    }
+
+    // =========================
+    //  Write Disassembly Cache
+    // =========================
+
+    cache_operand encode_operand( const x86_operand& operand ) {
+    	cache_operand result{};
+    	std::visit( [ & ]( auto&& op ) {
+    		using T = std::decay_t<decltype( op )>;
+    		if constexpr ( std::is_same_v<T,x86_register> ) {
+    			result.kind = cache_operand_kind::reg;
+    			result.reg = op;
+    		} else if constexpr ( std::is_same_v<T,x86_immediate> ) {
+    			result.kind = cache_operand_kind::immediate;
+    			result.value = op.value;
+    		} else if constexpr ( std::is_same_v<T,x86_address> ) {
+    			result.kind = cache_operand_kind::address;
+    			result.value = static_cast<int64_t>( op.addr );
+    		} else {
+    			result.kind = cache_operand_kind::memory;
+    			if ( op.base ) {
+    				result.flags |= cache_operand::has_base;
+    				result.reg = op.base.value();
+    			}
+    			if ( op.index ) {
+    				result.flags |= cache_operand::has_index;
+    				result.index = op.index.value();
+    			}
+    			if ( op.scale ) {
+    				result.flags |= cache_operand::has_scale;
+    				result.scale = op.scale.value();
+    			}
+    			if ( op.displacement ) {
+    				result.flags |= cache_operand::has_displacement;
+    				result.value = op.displacement.value();
+    			}
+    		}
+    	}, operand );
+    	return result;
+    }
+
+    template<typename T>
+    void write_records( std::ofstream& file, const std::vector<T>& records ) {
+    	file.write( reinterpret_cast<const char*>( records.data() ), static_cast<std::streamsize>( records.size() * sizeof( T ) ) );
+    }
+
+    std::expected<void,std::string> write_disassembly_cache( const std::string& file_name, const elf64_x86_64& elf, uint64_t source_hash, uint64_t source_size ) {
+    	cache_header header{};
+    	header.magic = cache_magic;
+    	header.version = cache_version;
+    	header.source_hash = source_hash;
+    	header.source_size = source_size;
+    	std::vector<cache_function> functions;
+    	std::vector<cache_instruction> instructions;
+    	std::vector<cache_operand> operands;
+    	std::vector<uint8_t> bytes;
+    	std::string names;
+    	for ( std::size_t i = 0; i < header.sections.size(); ++i ) {
+    		auto section = static_cast<elf_section>( i );
+    		const auto* section_functions = elf.functions( section );
+    		const auto* range = elf.range( section );
+    		header.sections[ i ] = { range->begin, range->end, static_cast<uint32_t>( functions.size() ), static_cast<uint32_t>( section_functions->size() ) };
+    		for ( const auto& func : *section_functions ) {
+    			functions.push_back( { static_cast<uint32_t>( names.size() ), static_cast<uint32_t>( func.name.size() ),
+    								   static_cast<uint32_t>( instructions.size() ), static_cast<uint32_t>( func.instructions.size() ) } );
+    			names += func.name;
+    			for ( const auto& instruction : func.instructions ) {
+    				if ( instruction.machine_bytes.size() > 0xff ) {
+    					return std::unexpected( "Too many Machine Bytes" );
+    				}
+    				if ( instruction.operands && instruction.operands->size() >= cache_instruction::no_operands ) {
+    					return std::unexpected( "Too many Operands" );
+    				}
+    				cache_instruction record{};
+    				record.address = instruction.address;
+    				record.byte_offset = static_cast<uint32_t>( bytes.size() );
+    				record.byte_count = static_cast<uint8_t>( instruction.machine_bytes.size() );
+    				record.mnemonic = instruction.mnemonic;
+    				record.operand_begin = static_cast<uint32_t>( operands.size() );
+    				record.operand_count = cache_instruction::no_operands;
+    				if ( instruction.operands ) {
+    					record.operand_count = static_cast<uint8_t>( instruction.operands->size() );
+    					for ( const auto& operand : instruction.operands.value() ) {
+    						operands.push_back( encode_operand( operand ) );
+    					}
+    				}
+    				bytes.insert( bytes.end(), instruction.machine_bytes.begin(), instruction.machine_bytes.end() );
+    				instructions.push_back( record );
+    			}
+    		}
+    	}
+    	constexpr std::size_t max_records = std::numeric_limits<uint32_t>::max();
+    	if ( instructions.size() > max_records || operands.size() > max_records || bytes.size() > max_records || names.size() > max_records ) {
+    		return std::unexpected( "Disassembly too large to Cache" );
+    	}
+    	header.function_count = functions.size();
+    	header.instruction_count = instructions.size();
+    	header.operand_count = operands.size();
+    	header.byte_count = bytes.size();
+    	header.name_bytes = names.size();
+
+    	// Written under a private name and renamed into place, so concurrent readers only
+    	// ever see a complete cache.
+    	std::string temp_name = file_name + ".tmp." + std::to_string( ::getpid() );
+    	{
+    		std::ofstream file( temp_name, std::ios::binary | std::ios::trunc );
+    		if ( !file ) {
+    			return std::unexpected( "Failed to Open Cache File" );
+    		}
+    		file.write( reinterpret_cast<const char*>( &header ), sizeof( header ) );
+    		write_records( file, functions );
+    		write_records( file, instructions );
+    		write_records( file, operands );
+    		write_records( file, bytes );
+    		file.write( names.data(), static_cast<std::streamsize>( names.size() ) );
+    		if ( !file.flush() ) {
+    			std::remove( temp_name.c_str() );
+    			return std::unexpected( "Failed to Write Cache File" );
+    		}
+    	}
+    	if ( std::rename( temp_name.c_str(), file_name.c_str() ) != 0 ) {
+    		std::remove( temp_name.c_str() );
+    		return std::unexpected( "Failed to Rename Cache File" );
+    	}
+    	return {};
+    }
+
+    // ========================
+    //  Open Disassembly Cache
+    // ========================
+
+    template<typename T>
+    std::span<const T> take_records( const char*& cursor, std::size_t count ) {
+    	std::span<const T> records( reinterpret_cast<const T*>( cursor ), count );
+    	cursor += count * sizeof( T );
+    	return records;
+    }
+
+    std::expected<disassembly_cache,std::string> open_disassembly_cache( const std::string& file_name ) {
+    	auto file = map_file( file_name, map_advice::normal );
+    	if ( !file ) {
+    		return std::unexpected( file.error() );
+    	}
+    	if ( file->size < sizeof( cache_header ) ) {
+    		return std::unexpected( "Cache File Truncated" );
+    	}
+    	const auto* header = reinterpret_cast<const cache_header*>( file->data );
+    	if ( header->magic != cache_magic ) {
+    		return std::unexpected( "Not a Disassembly Cache" );
+    	}
+    	if ( header->version != cache_version ) {
+    		return std::unexpected( "Cache Version Mismatch" );
+    	}
+    	// Every count is bounded by the file size first, so the sum below cannot overflow.
+    	std::size_t size = file->size;
+    	if ( header->function_count > size || header->instruction_count > size || header->operand_count > size ||
+    		 header->byte_count > size || header->name_bytes > size ||
+    		 sizeof( cache_header ) + header->function_count * sizeof( cache_function ) + header->instruction_count * sizeof( cache_instruction ) +
+    		 header->operand_count * sizeof( cache_operand ) + header->byte_count + header->name_bytes != size ) {
+    		return std::unexpected( "Cache File Truncated" );
+    	}
+    	disassembly_cache cache;
+    	const char* cursor = file->data + sizeof( cache_header );
+    	cache.header = header;
+    	cache.functions = take_records<cache_function>( cursor, header->function_count );
+    	cache.instructions = take_records<cache_instruction>( cursor, header->instruction_count );
+    	cache.operands = take_records<cache_operand>( cursor, header->operand_count );
+    	cache.bytes = take_records<uint8_t>( cursor, header->byte_count );
+    	cache.names = std::string_view( cursor, header->name_bytes );
+
+    	// Bounds are checked once here so the accessors can index without checks.
+    	for ( const auto& section : header->sections ) {
+    		if ( uint64_t{ section.function_begin } + section.function_count > cache.functions.size() ) {
+    			return std::unexpected( "Corrupt Cache Section" );
+    		}
+    	}
+    	for ( const auto& func : cache.functions ) {
+    		if ( uint64_t{ func.name_offset } + func.name_length > cache.names.size() ||
+    			 uint64_t{ func.instruction_begin } + func.instruction_count > cache.instructions.size() ) {
+    			return std::unexpected( "Corrupt Cache Function" );
+    		}
+    	}
+    	for ( const auto& instruction : cache.instructions ) {
+    		uint64_t operand_count = instruction.operand_count == cache_instruction::no_operands ? 0 : instruction.operand_count;
+    		if ( uint64_t{ instruction.byte_offset } + instruction.byte_count > cache.bytes.size() ||
+    			 instruction.operand_begin + operand_count > cache.operands.size() ) {
+    			return std::unexpected( "Corrupt Cache Instruction" );
+    		}
+    	}
+    	cache.file = std::move( file.value() );
+    	return cache;
+    }
+
+    // ========================
+    //  Load Disassembly Cache
+    // ========================
+
+    x86_operand decode_operand( const cache_operand& operand ) {
+    	switch ( operand.kind ) {
+    		case cache_operand_kind::reg:
+    			return operand.reg;
+    		case cache_operand_kind::immediate:
+    			return x86_immediate{ operand.value };
+    		case cache_operand_kind::address:
+    			return x86_address{ static_cast<uint64_t>( operand.value ) };
+    		default: {
+    			x86_memory memory;
+    			if ( operand.flags & cache_operand::has_base ) {
+    				memory.base = operand.reg;
+    			}
+    			if ( operand.flags & cache_operand::has_index ) {
+    				memory.index = operand.index;
+    			}
+    			if ( operand.flags & cache_operand::has_scale ) {
+    				memory.scale = operand.scale;
+    			}
+    			if ( operand.flags & cache_operand::has_displacement ) {
+    				memory.displacement = operand.value;
+    			}
+    			return memory;
+    		}
+    	}
+    }
+
+    x86_instruction disassembly_cache::instruction( const cache_instruction& instr, std::pmr::memory_resource* resource ) const {
+    	x86_instruction result( resource );
+    	result.address = instr.address;
+    	auto machine_bytes = bytes.subspan( instr.byte_offset, instr.byte_count );
+    	result.machine_bytes.assign( machine_bytes.begin(), machine_bytes.end() );
+    	result.mnemonic = instr.mnemonic;
+    	if ( instr.operand_count != cache_instruction::no_operands ) {
+    		auto& ops = result.operands.emplace( resource );
+    		ops.reserve( instr.operand_count );
+    		for ( const auto& operand : operands.subspan( instr.operand_begin, instr.operand_count ) ) {
+    			ops.push_back( decode_operand( operand ) );
+    		}
+    	}
+    	return result;
+    }
+
+    function disassembly_cache::to_function( const cache_function& func, std::pmr::memory_resource* resource ) const {
+    	function result( resource );
+    	result.name = name( func );
+    	result.instructions.reserve( func.instruction_count );
+    	for ( const auto& instr : instructions.subspan( func.instruction_begin, func.instruction_count ) ) {
+    		result.instructions.push_back( instruction( instr, resource ) );
+    	}
+    	return result;
+    }
+
+    elf64_x86_64 disassembly_cache::to_elf( std::pmr::memory_resource* resource ) const {
+    	elf64_x86_64 result;
+    	for ( std::size_t i = 0; i < header->sections.size(); ++i ) {
+    		auto section = static_cast<elf_section>( i );
+    		result.ranges[ i ] = { header->sections[ i ].begin, header->sections[ i ].end };
+    		auto* functions = result.functions( section );
+    		auto cached = section_functions( section );
+    		functions->reserve( cached.size() );
+    		for ( const auto& func : cached ) {
+    			functions->push_back( to_function( func, resource ) );
+    		}
+    	}
+    	return result;
+    }
+
+    // ==========================
+    //  Parse Disassembly Cached
+    // ==========================
+
+    std::expected<elf64_x86_64,std::string> parse_disassembly_cached( const std::string& source_file, const std::string& cache_file, std::size_t thread_count ) {
+    	auto source = map_file( source_file );
+    	if ( !source ) {
+    		return std::unexpected( source.error() );
+    	}
+    	uint64_t source_hash = hash_bytes( source->bytes() );
+    	if ( auto cache = open_disassembly_cache( cache_file ) ) {
+    		if ( cache->header->source_hash == source_hash && cache->header->source_size == source->size ) {
+    			return cache->to_elf();
+    		}
+    	}
+    	auto elf = parse_disassembly( source.value(), thread_count );
+    	if ( elf ) {
+    		// A cache that cannot be written only costs the next run a reparse.
+    		write_disassembly_cache( cache_file, elf.value(), source_hash, source->size );
+    	}
+    	return elf;
+    }
+
+    // ========================
+    //  Extract Function Names
+    // ========================
+
+    std::expected<std::vector<std::string>,std::string> extract_function_names( const std::string& file_name ) {
+    	auto file = map_file( file_name );
+    	if ( !file ) {
+    		return std::unexpected( file.error() );
+    	}
+    	auto names = extract_function_names( file.value() );
+    	if ( !names ) {
+    		return std::unexpected( names.error() );
+    	}
+    	return std::vector<std::string>( names->begin(), names->end() );
+    }
+
+    std::expected<std::vector<std::string_view>,std::string> extract_function_names( const mapped_file& file ) {
+    	std::vector<std::string_view> result;
+    	auto text = file.text();
+    	line_scanner lines( text );
+    	while ( lines.has_next() ) {
+    		if ( auto name = match_function_header( lines.next() ) ) {
+    			result.push_back( name.value() );
+    		}
+    	}
+    	return result;
+    }
+
+    // ================
+    //  Get Elf Header
+    // ================
+
+    std::expected<elf64_ehdr,std::string> get_elf_header( const std::string& file_name ) {
+		auto elf = open_elf_file( file_name );
+		if ( !elf ) {
+			return std::unexpected( elf.error() );
+		}
+	    return *elf->header;
+	}
+
+	// ==================
+    //  Parse Elf64 Shdr
+    // ==================
+
+	std::expected<std::vector<elf64_shdr>,std::string> parse_elf64_shdr( std::ifstream& file, elf64_ehdr& hdr ) {
+		if ( hdr.e_shentsize != sizeof( elf64_shdr ) ) {
+			return std::unexpected( "Invalid Section Header Size" );
+		}
+		std::vector<elf64_shdr> sections( hdr.e_shnum );
+		file.seekg( hdr.e_shoff );
+		file.read( reinterpret_cast<char*>( sections.data() ), sections.size() * sizeof( elf64_shdr ) );
+		if ( !file ) {
+			return std::unexpected( "Failed to Read Section Header" );
+		}
+		return sections;
+	}
+
+	// ==========
+    //  Elf File
+    // ==========
+
+	constexpr uint32_t sht_symtab = 2;
+	constexpr uint32_t sht_rela = 4;
+	constexpr uint32_t sht_nobits = 8;
+	constexpr uint8_t stt_func = 2;
+	constexpr uint8_t stb_local = 0;
+	constexpr uint16_t em_x86_64 = 62;
+
+	// offset and size come from the file, so compare without adding them.
+	bool within( std::span<const uint8_t> image, uint64_t offset, uint64_t size ) {
+		return offset <= image.size() && size <= image.size() - offset;
+	}
+
+	std::span<const uint8_t> elf_file::contents( const elf64_shdr& section ) const {
+		if ( section.sh_type == sht_nobits ) {
+			return {};
+		}
+		return image.subspan( section.sh_offset, section.sh_size );
+	}
+
+	std::string_view elf_file::string( const elf64_shdr& table, uint64_t offset ) const {
+		auto bytes = contents( table );
+		if ( offset >= bytes.size() ) {
+			return {};
+		}
+		std::string_view strings( reinterpret_cast<const char*>( bytes.data() ) + offset, bytes.size() - offset );
+		return strings.substr( 0, strings.find( '\0' ) );
+	}
+
+	const elf64_shdr* elf_file::find_section( std::string_view name ) const {
+		for ( const auto& section : sections ) {
+			if ( section_name( section ) == name ) {
+				return &section;
+			}
+		}
+		return nullptr;
+	}
+
+	std::span<const elf64_sym> elf_file::symbols( const elf64_shdr& table ) const {
+		auto bytes = contents( table );
+		return { reinterpret_cast<const elf64_sym*>( bytes.data() ), bytes.size() / sizeof( elf64_sym ) };
+	}
+
+	std::span<const elf64_rela> elf_file::relocations( const elf64_shdr& table ) const {
+		auto bytes = contents( table );
+		return { reinterpret_cast<const elf64_rela*>( bytes.data() ), bytes.size() / sizeof( elf64_rela ) };
+	}
+
+	std::expected<elf_file,std::string> open_elf_image( std::span<const uint8_t> image ) {
+		if ( image.size() < sizeof( elf64_ehdr ) || std::memcmp( image.data(), "\x7f" "ELF", 4 ) != 0 ) {
+			return std::unexpected( "Not an ELF File" );
+		}
+		elf_file elf;
+		elf.image = image;
+		elf.header = reinterpret_cast<const elf64_ehdr*>( image.data() );
+		const auto& header = *elf.header;
+		if ( header.e_ident[ 4 ] != 2 || header.e_ident[ 5 ] != 1 ) {
+			return std::unexpected( "Not a Little-Endian ELF64 File" );
+		}
+		// The packed header structs have alignment 1, so the tables can be viewed in place.
+		if ( header.e_shnum != 0 ) {
+			if ( header.e_shentsize != sizeof( elf64_shdr ) || header.e_shstrndx >= header.e_shnum ||
+				 !within( image, header.e_shoff, uint64_t{ header.e_shnum } * sizeof( elf64_shdr ) ) ) {
+				return std::unexpected( "Invalid Section Header Table" );
+			}
+			elf.sections = { reinterpret_cast<const elf64_shdr*>( image.data() + header.e_shoff ), header.e_shnum };
+		}
+		if ( header.e_phnum != 0 ) {
+			if ( header.e_phentsize != sizeof( elf64_phdr ) ||
+				 !within( image, header.e_phoff, uint64_t{ header.e_phnum } * sizeof( elf64_phdr ) ) ) {
+				return std::unexpected( "Invalid Program Header Table" );
+			}
+			elf.segments = { reinterpret_cast<const elf64_phdr*>( image.data() + header.e_phoff ), header.e_phnum };
+		}
+		for ( const auto& section : elf.sections ) {
+			if ( section.sh_type != sht_nobits && !within( image, section.sh_offset, section.sh_size ) ) {
+				return std::unexpected( "Section Outside File" );
+			}
+		}
+		for ( const auto& segment : elf.segments ) {
+			if ( !within( image, segment.p_offset, segment.p_filesz ) ) {
+				return std::unexpected( "Segment Outside File" );
+			}
+		}
+		return elf;
+	}
+
+	std::expected<elf_file,std::string> open_elf_file( const std::string& file_name ) {
+		auto file = map_file( file_name, map_advice::normal );
+		if ( !file ) {
+			return std::unexpected( file.error() );
+		}
+		auto elf = open_elf_image( file->bytes() );
+		if ( !elf ) {
+			return std::unexpected( elf.error() );
+		}
+		// Moving the mapping leaves its address unchanged, so the spans stay valid.
+		elf->file = std::move( file.value() );
+		return elf;
+	}
+
+	// ==============
+    //  Guest Memory
+    // ==============
+
+	constexpr uint32_t pt_load = 1;
+
+	// Finds the segment holding address, or nullptr.
+	template<typename Segments>
+	auto find_segment( Segments& segments, uint64_t address ) -> decltype( &segments.front() ) {
+		auto it = std::upper_bound( segments.begin(), segments.end(), address, []( uint64_t target, const guest_segment& segment ) {
+			return target < segment.address;
+		} );
+		if ( it == segments.begin() || !std::prev( it )->contains( address ) ) {
+			return nullptr;
+		}
+		return &*std::prev( it );
+	}
+
+	uint64_t guest_stack::load( uint64_t address, std::size_t size ) const {
+		uint64_t value = 0;
+		uint64_t bottom = top - bytes.size();
+		if ( address >= bottom ) {
+			std::memcpy( &value, bytes.data() + ( address - bottom ), size );
+		} else if ( address + size > bottom ) {
+			std::memcpy( reinterpret_cast<uint8_t*>( &value ) + ( bottom - address ), bytes.data(), address + size - bottom );
+		}
+		return value;
+	}
+
+	void guest_stack::store( uint64_t address, uint64_t value, std::size_t size ) {
+		if ( address < top - bytes.size() ) {
+			// Grow down: the used part moves to the end of a buffer at least twice the size.
+			std::size_t needed = static_cast<std::size_t>( top - address );
+			std::size_t grown = std::min<std::size_t>( limit, std::max<std::size_t>( { needed, bytes.size() * 2, guest_memory::page_size } ) );
+			std::vector<uint8_t> moved( grown );
+			std::memcpy( moved.data() + ( grown - bytes.size() ), bytes.data(), bytes.size() );
+			bytes = std::move( moved );
+		}
+		std::memcpy( bytes.data() + ( address - ( top - bytes.size() ) ), &value, size );
+	}
+
+	std::expected<void,std::string> guest_memory::read( uint64_t address, std::span<uint8_t> out ) const {
+		if ( stack.contains( address, out.size() ) ) {
+			for ( std::size_t i = 0; i < out.size(); i += sizeof( uint64_t ) ) {
+				std::size_t n = std::min( out.size() - i, sizeof( uint64_t ) );
+				uint64_t value = stack.load( address + i, n );
+				std::memcpy( out.data() + i, &value, n );
+			}
+			return {};
+		}
+		while ( !out.empty() ) {
+			const auto* segment = find_segment( segments, address );
+			if ( segment == nullptr ) {
+				return std::unexpected( "Unmapped Memory" );
+			}
+			if ( !( segment->flags & segment_read ) ) {
+				return std::unexpected( "Read from unreadable Memory" );
+			}
+			uint64_t offset = address - segment->address;
+			uint64_t in_page = offset % page_size;
+			std::size_t n = std::min<uint64_t>( { out.size(), page_size - in_page, segment->size - offset } );
+			if ( const auto& page = segment->pages[ offset / page_size ] ) {
+				std::memcpy( out.data(), page.get() + in_page, n );
+			} else {
+				std::size_t from_file = offset < segment->file_bytes.size() ? std::min<uint64_t>( n, segment->file_bytes.size() - offset ) : 0;
+				if ( from_file != 0 ) {
+					std::memcpy( out.data(), segment->file_bytes.data() + offset, from_file );
+				}
+				std::memset( out.data() + from_file, 0, n - from_file );
+			}
+			address += n;
+			out = out.subspan( n );
+		}
+		return {};
+	}
+
+	std::expected<void,std::string> guest_memory::write( uint64_t address, std::span<const uint8_t> in ) {
+		if ( stack.contains( address, in.size() ) ) {
+			for ( std::size_t i = 0; i < in.size(); i += sizeof( uint64_t ) ) {
+				std::size_t n = std::min( in.size() - i, sizeof( uint64_t ) );
+				uint64_t value = 0;
+				std::memcpy( &value, in.data() + i, n );
+				stack.store( address + i, value, n );
+			}
+			return {};
+		}
+		while ( !in.empty() ) {
+			auto* segment = find_segment( segments, address );
+			if ( segment == nullptr ) {
+				return std::unexpected( "Unmapped Memory" );
+			}
+			if ( !( segment->flags & segment_write ) ) {
+				return std::unexpected( "Write to read-only Memory" );
+			}
+			uint64_t offset = address - segment->address;
+			uint64_t page_start = offset - offset % page_size;
+			std::size_t n = std::min<uint64_t>( { in.size(), page_size - offset % page_size, segment->size - offset } );
+			auto& page = segment->pages[ page_start / page_size ];
+			if ( !page ) {
+				// Copy-on-write: the page starts as the file bytes, zero past them.
+				page = std::make_unique<uint8_t[]>( page_size );
+				if ( page_start < segment->file_bytes.size() ) {
+					std::size_t from_file = std::min<uint64_t>( page_size, segment->file_bytes.size() - page_start );
+					std::memcpy( page.get(), segment->file_bytes.data() + page_start, from_file );
+				}
+			}
+			std::memcpy( page.get() + offset % page_size, in.data(), n );
+			address += n;
+			in = in.subspan( n );
+		}
+		return {};
+	}
+
+	std::expected<uint64_t,std::string> guest_memory::load( uint64_t address, std::size_t size ) const {
+		if ( size == 0 || size > sizeof( uint64_t ) ) {
+			return std::unexpected( "Invalid Access Size" );
+		}
+		if ( stack.contains( address, size ) ) {
+			return stack.load( address, size );
+		}
+		std::array<uint8_t,sizeof( uint64_t )> bytes{};
+		if ( auto result = read( address, std::span( bytes ).first( size ) ); !result ) {
+			return std::unexpected( result.error() );
+		}
+		uint64_t value;
+		std::memcpy( &value, bytes.data(), sizeof( value ) );
+		return value;
+	}
+
+	std::expected<void,std::string> guest_memory::store( uint64_t address, uint64_t value, std::size_t size ) {
+		if ( size == 0 || size > sizeof( uint64_t ) ) {
+			return std::unexpected( "Invalid Access Size" );
+		}
+		if ( stack.contains( address, size ) ) {
+			stack.store( address, value, size );
+			return {};
+		}
+		std::array<uint8_t,sizeof( uint64_t )> bytes;
+		std::memcpy( bytes.data(), &value, sizeof( value ) );
+		return write( address, std::span( bytes ).first( size ) );
+	}
+
+	std::size_t guest_memory::private_pages() const {
+		std::size_t count = 0;
+		for ( const auto& segment : segments ) {
+			count += std::count_if( segment.pages.begin(), segment.pages.end(), []( const auto& page ) { return page != nullptr; } );
+		}
+		return count;
+	}
+
+	std::expected<guest_memory,std::string> load_segments( const elf_file& elf ) {
+		guest_memory memory;
+		for ( const auto& phdr : elf.segments ) {
+			if ( phdr.p_type != pt_load || phdr.p_memsz == 0 ) {
+				continue;
+			}
+			if ( phdr.p_filesz > phdr.p_memsz ) {
+				return std::unexpected( "Segment File Size exceeds Memory Size" );
+			}
+			guest_segment segment;
+			segment.address = phdr.p_vaddr;
+			segment.size = phdr.p_memsz;
+			segment.file_bytes = elf.image.subspan( phdr.p_offset, phdr.p_filesz );
+			segment.flags = phdr.p_flags;
+			segment.pages.resize( ( phdr.p_memsz + guest_memory::page_size - 1 ) / guest_memory::page_size );
+			memory.segments.push_back( std::move( segment ) );
+		}
+		std::sort( memory.segments.begin(), memory.segments.end(), []( const guest_segment& lhs, const guest_segment& rhs ) {
+			return lhs.address < rhs.address;
+		} );
+		for ( std::size_t i = 1; i < memory.segments.size(); ++i ) {
+			if ( memory.segments[ i ].address - memory.segments[ i - 1 ].address < memory.segments[ i - 1 ].size ) {
+				return std::unexpected( "Overlapping Segments" );
+			}
+		}
+		return memory;
+	}
+
+	// ===============
+    //  Opcode Tables
+    // ===============
+
+	// How an operand is encoded. Specs list their operands in AT&T order.
+	enum class operand_form : uint8_t {
+		none,
+		E,     // ModRM r/m, register or memory
+		M,     // ModRM r/m, memory only
+		G,     // ModRM reg
+		Z,     // register in the low three opcode bits
+		A,     // accumulator
+		CL,
+		one,   // the implicit 1 of the d0/d1 shifts
+		Ib,    // imm8, sign-extended to the operand size
+		Iu,    // imm8, unsigned (shift counts)
+		Iz,    // imm16/32, sign-extended to the operand size
+		Iv,    // imm16/32/64, the full operand size
+		Jb,    // rel8 branch target
+		Jz     // rel32 branch target
+	};
+
+	enum opcode_flags : uint8_t {
+		op_valid = 1 << 0,
+		op_modrm = 1 << 1,
+		op_group = 1 << 2,       // ModRM.reg picks the mnemonic from extensions
+		op_byte = 1 << 3,        // 8-bit operands
+		op_default64 = 1 << 4,   // 64-bit operands without REX.W
+		op_suffix = 1 << 5       // objdump spells out the size when r/m is memory
+	};
+
+	// How many opcodes one spec covers.
+	enum class opcode_shape : uint8_t {
+		single,
+		registers,   // eight opcodes, the register in the low three bits
+		alu          // the six classic ALU forms: Eb,Gb  Ev,Gv  Gb,Eb  Gv,Ev  AL,Ib  eAX,Iz
+	};
+
+	// The declarative description the decode tables are generated from. Adding an
+	// encoding is one row here; a new mnemonic also needs its x86_mnemonic and
+	// mnemonic_infos row.
+	struct opcode_spec {
+		x86_mnemonic mnemonic;
+		uint16_t opcode;                         // 0x0fxx for the two-byte map
+		uint8_t flags;
+		std::array<operand_form,2> operands{};
+		int8_t extension = -1;                   // ModRM.reg for group opcodes
+		opcode_shape shape = opcode_shape::single;
+	};
+
+	using enum operand_form;
+
+	constexpr uint8_t op_rm = op_valid | op_modrm;
+	constexpr uint8_t op_ext = op_valid | op_modrm | op_group;
+
+	constexpr std::array opcode_specs = {
+		opcode_spec{ x86_mnemonic::add,     0x00, op_valid, {}, -1, opcode_shape::alu },
+		opcode_spec{ x86_mnemonic::and_,    0x20, op_valid, {}, -1, opcode_shape::alu },
+		opcode_spec{ x86_mnemonic::sub,     0x28, op_valid, {}, -1, opcode_shape::alu },
+		opcode_spec{ x86_mnemonic::xor_,    0x30, op_valid, {}, -1, opcode_shape::alu },
+		opcode_spec{ x86_mnemonic::cmp,     0x38, op_valid, {}, -1, opcode_shape::alu },
+		opcode_spec{ x86_mnemonic::push,    0x50, op_valid | op_default64, { Z }, -1, opcode_shape::registers },
+		opcode_spec{ x86_mnemonic::pop,     0x58, op_valid | op_default64, { Z }, -1, opcode_shape::registers },
+		opcode_spec{ x86_mnemonic::je,      0x74, op_valid, { Jb } },
+		opcode_spec{ x86_mnemonic::jne,     0x75, op_valid, { Jb } },
+		opcode_spec{ x86_mnemonic::add,     0x80, op_ext | op_byte | op_suffix, { Ib, E }, 0 },
+		opcode_spec{ x86_mnemonic::and_,    0x80, op_ext | op_byte | op_suffix, { Ib, E }, 4 },
+		opcode_spec{ x86_mnemonic::sub,     0x80, op_ext | op_byte | op_suffix, { Ib, E }, 5 },
+		opcode_spec{ x86_mnemonic::xor_,    0x80, op_ext | op_byte | op_suffix, { Ib, E }, 6 },
+		opcode_spec{ x86_mnemonic::cmp,     0x80, op_ext | op_byte | op_suffix, { Ib, E }, 7 },
+		opcode_spec{ x86_mnemonic::add,     0x81, op_ext | op_suffix, { Iz, E }, 0 },
+		opcode_spec{ x86_mnemonic::and_,    0x81, op_ext | op_suffix, { Iz, E }, 4 },
+		opcode_spec{ x86_mnemonic::sub,     0x81, op_ext | op_suffix, { Iz, E }, 5 },
+		opcode_spec{ x86_mnemonic::xor_,    0x81, op_ext | op_suffix, { Iz, E }, 6 },
+		opcode_spec{ x86_mnemonic::cmp,     0x81, op_ext | op_suffix, { Iz, E }, 7 },
+		opcode_spec{ x86_mnemonic::add,     0x83, op_ext | op_suffix, { Ib, E }, 0 },
+		opcode_spec{ x86_mnemonic::and_,    0x83, op_ext | op_suffix, { Ib, E }, 4 },
+		opcode_spec{ x86_mnemonic::sub,     0x83, op_ext | op_suffix, { Ib, E }, 5 },
+		opcode_spec{ x86_mnemonic::xor_,    0x83, op_ext | op_suffix, { Ib, E }, 6 },
+		opcode_spec{ x86_mnemonic::cmp,     0x83, op_ext | op_suffix, { Ib, E }, 7 },
+		opcode_spec{ x86_mnemonic::test,    0x84, op_rm | op_byte, { G, E } },
+		opcode_spec{ x86_mnemonic::test,    0x85, op_rm, { G, E } },
+		opcode_spec{ x86_mnemonic::mov,     0x88, op_rm | op_byte, { G, E } },
+		opcode_spec{ x86_mnemonic::mov,     0x89, op_rm, { G, E } },
+		opcode_spec{ x86_mnemonic::mov,     0x8a, op_rm | op_byte, { E, G } },
+		opcode_spec{ x86_mnemonic::mov,     0x8b, op_rm, { E, G } },
+		opcode_spec{ x86_mnemonic::lea,     0x8d, op_rm, { M, G } },
+		opcode_spec{ x86_mnemonic::test,    0xa8, op_valid | op_byte, { Ib, A } },
+		opcode_spec{ x86_mnemonic::test,    0xa9, op_valid, { Iz, A } },
+		opcode_spec{ x86_mnemonic::xchg,    0x90, op_valid, { A, Z }, -1, opcode_shape::registers },
+		opcode_spec{ x86_mnemonic::mov,     0xb0, op_valid | op_byte, { Ib, Z }, -1, opcode_shape::registers },
+		opcode_spec{ x86_mnemonic::mov,     0xb8, op_valid, { Iv, Z }, -1, opcode_shape::registers },
+		opcode_spec{ x86_mnemonic::shr,     0xc0, op_ext | op_byte | op_suffix, { Iu, E }, 5 },
+		opcode_spec{ x86_mnemonic::sar,     0xc0, op_ext | op_byte | op_suffix, { Iu, E }, 7 },
+		opcode_spec{ x86_mnemonic::shr,     0xc1, op_ext | op_suffix, { Iu, E }, 5 },
+		opcode_spec{ x86_mnemonic::sar,     0xc1, op_ext | op_suffix, { Iu, E }, 7 },
+		opcode_spec{ x86_mnemonic::ret,     0xc3, op_valid },
+		opcode_spec{ x86_mnemonic::mov,     0xc6, op_ext | op_byte | op_suffix, { Ib, E }, 0 },
+		opcode_spec{ x86_mnemonic::mov,     0xc7, op_ext | op_suffix, { Iz, E }, 0 },
+		opcode_spec{ x86_mnemonic::shr,     0xd0, op_ext | op_byte | op_suffix, { one, E }, 5 },
+		opcode_spec{ x86_mnemonic::sar,     0xd0, op_ext | op_byte | op_suffix, { one, E }, 7 },
+		opcode_spec{ x86_mnemonic::shr,     0xd1, op_ext | op_suffix, { one, E }, 5 },
+		opcode_spec{ x86_mnemonic::sar,     0xd1, op_ext | op_suffix, { one, E }, 7 },
+		opcode_spec{ x86_mnemonic::shr,     0xd2, op_ext | op_byte | op_suffix, { CL, E }, 5 },
+		opcode_spec{ x86_mnemonic::sar,     0xd2, op_ext | op_byte | op_suffix, { CL, E }, 7 },
+		opcode_spec{ x86_mnemonic::shr,     0xd3, op_ext | op_suffix, { CL, E }, 5 },
+		opcode_spec{ x86_mnemonic::sar,     0xd3, op_ext | op_suffix, { CL, E }, 7 },
+		opcode_spec{ x86_mnemonic::call,    0xe8, op_valid, { Jz } },
+		opcode_spec{ x86_mnemonic::jmp,     0xe9, op_valid, { Jz } },
+		opcode_spec{ x86_mnemonic::jmp,     0xeb, op_valid, { Jb } },
+		opcode_spec{ x86_mnemonic::hlt,     0xf4, op_valid },
+		opcode_spec{ x86_mnemonic::test,    0xf6, op_ext | op_byte | op_suffix, { Ib, E }, 0 },
+		opcode_spec{ x86_mnemonic::test,    0xf7, op_ext | op_suffix, { Iz, E }, 0 },
+		opcode_spec{ x86_mnemonic::call,    0xff, op_ext | op_default64, { E }, 2 },
+		opcode_spec{ x86_mnemonic::jmp,     0xff, op_ext | op_default64, { E }, 4 },
+		opcode_spec{ x86_mnemonic::push,    0xff, op_ext | op_default64, { E }, 6 },
+		opcode_spec{ x86_mnemonic::endbr64, 0x0f1e, op_rm },
+		opcode_spec{ x86_mnemonic::nopl,    0x0f1f, op_ext | op_suffix, { E }, 0 },
+		opcode_spec{ x86_mnemonic::je,      0x0f84, op_valid, { Jz } },
+		opcode_spec{ x86_mnemonic::jne,     0x0f85, op_valid, { Jz } },
+		opcode_spec{ x86_mnemonic::cmpxchg, 0x0fb0, op_rm | op_byte, { G, E } },
+		opcode_spec{ x86_mnemonic::cmpxchg, 0x0fb1, op_rm, { G, E } }
+	};
+
+	// A decode table slot. Group opcodes carry their ModRM.reg extensions inline, so
+	// decoding is one load from the opcode table and one from extensions.
+	struct opcode_entry {
+		x86_mnemonic mnemonic{};
+		uint8_t flags = 0;
+		uint8_t extension_mask = 0;
+		std::array<operand_form,2> operands{};
+		std::array<x86_mnemonic,8> extensions{};
+	};
+
+	using opcode_table = std::array<opcode_entry,256>;
+
+	constexpr void set_opcode( opcode_table& table, uint8_t opcode, x86_mnemonic mnemonic, uint8_t flags,
+							   std::array<operand_form,2> operands, int8_t extension ) {
+		auto& entry = table[ opcode ];
+		if ( entry.flags && ( entry.flags != flags || entry.operands != operands || extension < 0 ) ) {
+			throw "opcode_specs: conflicting specs for one opcode";
+		}
+		entry.mnemonic = mnemonic;
+		entry.flags = flags;
+		entry.operands = operands;
+		if ( extension >= 0 ) {
+			if ( entry.extension_mask & ( 1 << extension ) ) {
+				throw "opcode_specs: duplicate group extension";
+			}
+			entry.extension_mask |= static_cast<uint8_t>( 1 << extension );
+			entry.extensions[ extension ] = mnemonic;
+		}
+	}
+
+	constexpr std::array<opcode_table,2> build_opcode_tables() {
+		std::array<opcode_table,2> tables{};
+		for ( const auto& spec : opcode_specs ) {
+			auto& table = tables[ spec.opcode >> 8 == 0x0f ? 1 : 0 ];
+			uint8_t opcode = static_cast<uint8_t>( spec.opcode );
+			switch ( spec.shape ) {
+				case opcode_shape::single:
+					set_opcode( table, opcode, spec.mnemonic, spec.flags, spec.operands, spec.extension );
+					break;
+				case opcode_shape::registers:
+					for ( uint8_t r = 0; r < 8; ++r ) {
+						set_opcode( table, opcode + r, spec.mnemonic, spec.flags, spec.operands, spec.extension );
+					}
+					break;
+				case opcode_shape::alu:
+					set_opcode( table, opcode + 0, spec.mnemonic, op_rm | op_byte, { G, E }, -1 );
+					set_opcode( table, opcode + 1, spec.mnemonic, op_rm, { G, E }, -1 );
+					set_opcode( table, opcode + 2, spec.mnemonic, op_rm | op_byte, { E, G }, -1 );
+					set_opcode( table, opcode + 3, spec.mnemonic, op_rm, { E, G }, -1 );
+					set_opcode( table, opcode + 4, spec.mnemonic, op_valid | op_byte, { Ib, A }, -1 );
+					set_opcode( table, opcode + 5, spec.mnemonic, op_valid, { Iz, A }, -1 );
+					break;
+			}
+		}
+		return tables;
+	}
+
+	constexpr std::array<opcode_table,2> opcode_tables = build_opcode_tables();
+
+	// 90 is xchg %eax,%eax by encoding but nop by definition.
+	constexpr opcode_entry nop_entry{ x86_mnemonic::nop, op_valid };
+
+	// Everything a ModRM byte says on its own, so the decoder reads it rather than
+	// re-deriving it from mod and rm.
+	struct modrm_form {
+		uint8_t reg;
+		uint8_t rm;
+		uint8_t displacement;   // bytes of displacement, before any SIB override
+		bool memory;
+		bool sib;
+		bool rip;
+	};
+
+	constexpr std::array<modrm_form,256> modrm_forms = [] {
+		std::array<modrm_form,256> forms{};
+		for ( std::size_t i = 0; i < forms.size(); ++i ) {
+			uint8_t mod = static_cast<uint8_t>( i >> 6 );
+			uint8_t rm = static_cast<uint8_t>( i & 7 );
+			forms[ i ] = {
+				static_cast<uint8_t>( ( i >> 3 ) & 7 ),
+				rm,
+				static_cast<uint8_t>( mod == 1 ? 1 : mod == 2 || ( mod == 0 && rm == 5 ) ? 4 : 0 ),
+				mod != 3,
+				mod != 3 && rm == 4,
+				mod == 0 && rm == 5
+			};
+		}
+		return forms;
+	}();
+
+	// objdump names the operand size in the mnemonic when no register operand implies
+	// it; indexed by mnemonic and log2 of the width in bytes.
+	constexpr std::array<std::array<std::optional<x86_mnemonic>,4>,mnemonic_infos.size()> suffixed_mnemonics = [] {
+		std::array<std::array<std::optional<x86_mnemonic>,4>,mnemonic_infos.size()> table{};
+		for ( const auto& info : mnemonic_infos ) {
+			if ( info.base ) {
+				table[ static_cast<std::size_t>( info.base.value() ) ][ std::countr_zero( info.width / 8u ) ] = info.mnemonic;
+			}
+		}
+		return table;
+	}();
+
+	// =========================
+    //  Decode x86 Instruction
+    // =========================
+
+	// Register numbers to registers for 64, 32, 16 and 8-bit operands, plus the 8-bit
+	// set without a REX prefix, where encodings 4-7 are the legacy high byte registers.
+	constexpr std::array<std::array<x86_register,16>,5> general_registers = [] {
+		std::array<std::array<x86_register,16>,5> table{};
+		constexpr std::array<x86_register,4> firsts = { x86_register::rax, x86_register::eax, x86_register::ax, x86_register::al };
+		for ( std::size_t set = 0; set < 5; ++set ) {
+			for ( uint8_t index = 0; index < 16; ++index ) {
+				auto first = firsts[ std::min<std::size_t>( set, 3 ) ];
+				table[ set ][ index ] = static_cast<x86_register>( static_cast<uint8_t>( first ) + index );
+			}
+		}
+		for ( uint8_t index = 4; index < 8; ++index ) {
+			table[ 4 ][ index ] = static_cast<x86_register>( static_cast<uint8_t>( x86_register::ah ) + index - 4 );
+		}
+		return table;
+	}();
+
+	inline x86_register general_register( int width, uint8_t index, bool rex ) {
+		std::size_t set = width == 64 ? 0 : width == 32 ? 1 : width == 16 ? 2 : rex ? 3 : 4;
+		return general_registers[ set ][ index ];
+	}
+
+	// objdump prints immediates as unsigned values of the operand size, which the text
+	// parser reads back as is (or wrapped, for 64-bit operands).
+	int64_t immediate_value( int64_t value, int width ) {
+		if ( width == 64 ) {
+			return value;
+		}
+		return static_cast<int64_t>( static_cast<uint64_t>( value ) & ( ( uint64_t{ 1 } << width ) - 1 ) );
+	}
+
+	enum prefix_kind : uint8_t {
+		not_prefix,
+		prefix_ignored,    // lock, repne and segment overrides
+		prefix_operand_size,
+		prefix_address_size,
+		prefix_rep
+	};
+
+	constexpr std::array<uint8_t,256> prefix_kinds = [] {
+		std::array<uint8_t,256> kinds{};
+		for ( uint8_t prefix : { 0xf0, 0xf2, 0x26, 0x2e, 0x36, 0x3e, 0x64, 0x65 } ) {
+			kinds[ prefix ] = prefix_ignored;
+		}
+		kinds[ 0x66 ] = prefix_operand_size;
+		kinds[ 0x67 ] = prefix_address_size;
+		kinds[ 0xf3 ] = prefix_rep;
+		return kinds;
+	}();
+
+	// Reads a little-endian value of size bytes at pos and sign-extends it.
+	bool read_signed( std::span<const uint8_t> bytes, std::size_t& pos, std::size_t size, int64_t& value ) {
+		if ( pos + size > bytes.size() ) {
+			return false;
+		}
+		uint64_t raw = 0;
+		std::memcpy( &raw, bytes.data() + pos, size );
+		pos += size;
+		std::size_t shift = 64 - 8 * size;
+		value = static_cast<int64_t>( raw << shift ) >> shift;
+		return true;
+	}
+
+	// The decoder proper: fills instruction in place, operands straight into its
+	// columns, and reports failure as a code, so decode_instructions can run it over a
+	// buffer without touching the heap.
+	decode_error decode_into( std::span<const uint8_t> bytes, uint64_t address, x86_compact_instruction& instruction ) {
+		bytes = bytes.first( std::min( bytes.size(), x86_compact_instruction::max_bytes ) );
+		instruction = x86_compact_instruction{};
+		instruction.address = address;
+		std::size_t pos = 0;
+		bool operand_size_16 = false;
+		bool address_size_32 = false;
+		bool rep = false;
+		for ( ; pos < bytes.size(); ++pos ) {
+			uint8_t kind = prefix_kinds[ bytes[ pos ] ];
+			if ( kind == not_prefix ) {
+				break;
+			}
+			operand_size_16 |= kind == prefix_operand_size;
+			address_size_32 |= kind == prefix_address_size;
+			rep |= kind == prefix_rep;
+		}
+		uint8_t rex = 0;
+		if ( pos < bytes.size() && ( bytes[ pos ] & 0xf0 ) == 0x40 ) {
+			rex = bytes[ pos++ ];
+		}
+		if ( pos >= bytes.size() ) {
+			return decode_error::truncated;
+		}
+		uint8_t opcode = bytes[ pos++ ];
+		const opcode_entry* entry = &opcode_tables[ 0 ][ opcode ];
+		if ( opcode == 0x0f ) {
+			if ( pos >= bytes.size() ) {
+				return decode_error::truncated;
+			}
+			opcode = bytes[ pos++ ];
+			entry = &opcode_tables[ 1 ][ opcode ];
+		}
+		if ( entry == &opcode_tables[ 0 ][ 0x90 ] && !( rex & 0x1 ) && !operand_size_16 ) {
+			if ( rep ) {
+				return decode_error::unsupported_opcode;
+			}
+			entry = &nop_entry;
+		}
+		if ( !( entry->flags & op_valid ) ) {
+			return decode_error::unsupported_opcode;
+		}
+
+		uint8_t modrm = 0;
+		if ( entry->flags & op_modrm ) {
+			if ( pos >= bytes.size() ) {
+				return decode_error::truncated;
+			}
+			modrm = bytes[ pos++ ];
+		}
+		const modrm_form& form = modrm_forms[ modrm ];
+		uint8_t reg = form.reg | ( ( rex & 0x4 ) << 1 );
+		uint8_t rm = form.rm | ( ( rex & 0x1 ) << 3 );
+
+		x86_mnemonic mnemonic = entry->mnemonic;
+		if ( entry->flags & op_group ) {
+			if ( !( entry->extension_mask & ( 1 << form.reg ) ) ) {
+				return decode_error::unsupported_opcode;
+			}
+			mnemonic = entry->extensions[ form.reg ];
+		}
+		if ( mnemonic == x86_mnemonic::endbr64 && ( !rep || modrm != 0xfa ) ) {
+			return decode_error::unsupported_opcode;
+		}
+		int width = 32;
+		if ( entry->flags & op_byte ) {
+			width = 8;
+		} else if ( rex & 0x8 ) {
+			width = 64;
+		} else if ( operand_size_16 ) {
+			width = 16;
+		} else if ( entry->flags & op_default64 ) {
+			width = 64;
+		}
+
+		// ModRM, SIB and displacement all come before any immediate.
+		bool is_memory = ( entry->flags & op_modrm ) && form.memory;
+		uint8_t memory_flags = static_cast<uint8_t>( x86_operand_kind::memory );
+		x86_register memory_base{};
+		x86_register memory_index{};
+		uint8_t memory_scale = 0;
+		int64_t displacement = 0;
+		if ( is_memory ) {
+			int address_width = address_size_32 ? 32 : 64;
+			std::size_t displacement_size = form.displacement;
+			if ( form.sib ) {
+				if ( pos >= bytes.size() ) {
+					return decode_error::truncated;
+				}
+				uint8_t sib = bytes[ pos++ ];
+				uint8_t index = ( ( sib >> 3 ) & 7 ) | ( ( rex & 0x2 ) << 2 );
+				uint8_t base = ( sib & 7 ) | ( ( rex & 0x1 ) << 3 );
+				if ( index != 4 ) {
+					memory_flags |= x86_compact_instruction::has_index | x86_compact_instruction::has_scale;
+					memory_index = general_register( address_width, index, true );
+					memory_scale = static_cast<uint8_t>( 1 << ( sib >> 6 ) );
+				}
+				if ( ( sib & 7 ) == 5 && modrm >> 6 == 0 ) {
+					displacement_size = 4;
+				} else {
+					memory_flags |= x86_compact_instruction::has_base;
+					memory_base = general_register( address_width, base, true );
+				}
+			} else {
+				memory_flags |= x86_compact_instruction::has_base;
+				memory_base = form.rip ? ( address_size_32 ? x86_register::eip : x86_register::rip ) : general_register( address_width, rm, true );
+			}
+			if ( displacement_size ) {
+				if ( !read_signed( bytes, pos, displacement_size, displacement ) ) {
+					return decode_error::truncated;
+				}
+				memory_flags |= x86_compact_instruction::has_displacement;
+			}
+		}
+
+		auto next_slot = [ & ]( x86_operand_kind kind ) {
+			std::size_t i = instruction.operand_count == x86_compact_instruction::no_operands ? 0 : instruction.operand_count;
+			instruction.operand_count = static_cast<uint8_t>( i + 1 );
+			instruction.operand_flags[ i ] = static_cast<uint8_t>( kind );
+			return i;
+		};
+		auto push_register = [ & ]( x86_register reg ) {
+			instruction.regs[ next_slot( x86_operand_kind::reg ) ] = reg;
+		};
+		for ( auto operand : entry->operands ) {
+			std::size_t immediate_size = 0;
+			switch ( operand ) {
+				case none:
+					continue;
+				case E:
+				case M:
+					if ( is_memory ) {
+						std::size_t i = next_slot( x86_operand_kind::memory );
+						instruction.operand_flags[ i ] = memory_flags;
+						instruction.regs[ i ] = memory_base;
+						instruction.indexes[ i ] = memory_index;
+						instruction.scales[ i ] = memory_scale;
+						instruction.values[ i ] = displacement;
+					} else if ( operand == M ) {
+						return decode_error::expected_memory;
+					} else {
+						push_register( general_register( width, rm, rex ) );
+					}
+					continue;
+				case G:
+					push_register( general_register( width, reg, rex ) );
+					continue;
+				case Z:
+					push_register( general_register( width, ( opcode & 7 ) | ( ( rex & 0x1 ) << 3 ), rex ) );
+					continue;
+				case A:
+					push_register( general_register( width, 0, rex ) );
+					continue;
+				case CL:
+					push_register( x86_register::cl );
+					continue;
+				case one:
+					instruction.values[ next_slot( x86_operand_kind::immediate ) ] = 1;
+					continue;
+				case Ib:
+				case Iu:
+				case Jb:
+					immediate_size = 1;
+					break;
+				case Iz:
+				case Jz:
+					immediate_size = width == 16 && operand == Iz ? 2 : 4;
+					break;
+				case Iv:
+					immediate_size = width / 8;
+					break;
+			}
+			int64_t value = 0;
+			if ( !read_signed( bytes, pos, immediate_size, value ) ) {
+				return decode_error::truncated;
+			}
+			if ( operand == Jb || operand == Jz ) {
+				instruction.values[ next_slot( x86_operand_kind::address ) ] = static_cast<int64_t>( address + pos + static_cast<uint64_t>( value ) );
+			} else {
+				instruction.values[ next_slot( x86_operand_kind::immediate ) ] = immediate_value( value, operand == Iu ? 8 : width );
+			}
+		}
+
+		if ( ( entry->flags & op_suffix ) && is_memory ) {
+			auto suffixed = suffixed_mnemonics[ static_cast<std::size_t>( mnemonic ) ][ std::countr_zero( width / 8u ) ];
+			if ( !suffixed ) {
+				return decode_error::unsupported_operand_size;
+			}
+			mnemonic = suffixed.value();
+		}
+		instruction.mnemonic = mnemonic;
+		instruction.byte_count = static_cast<uint8_t>( pos );
+		std::copy_n( bytes.begin(), pos, instruction.machine_bytes.begin() );
+		return decode_error::none;
+	}
+
+	std::expected<x86_compact_instruction,std::string> decode_compact_instruction( std::span<const uint8_t> bytes, uint64_t address ) {
+		x86_compact_instruction instruction;
+		if ( auto error = decode_into( bytes, address, instruction ); error != decode_error::none ) {
+			return std::unexpected( std::string( decode_error_message( error ) ) );
+		}
+		return instruction;
+	}
+
+	decode_batch_result decode_instructions( std::span<const uint8_t> bytes, uint64_t address, std::span<x86_compact_instruction> out ) {
+		decode_batch_result result;
+		while ( result.count < out.size() && result.consumed < bytes.size() ) {
+			auto& instruction = out[ result.count ];
+			result.error = decode_into( bytes.subspan( result.consumed ), address + result.consumed, instruction );
+			if ( result.error != decode_error::none ) {
+				break;
+			}
+			result.consumed += instruction.byte_count;
+			++result.count;
+		}
+		return result;
+	}
+
+	// =======================
+    //  Parse x86 Instruction
+    // =======================
+
+	std::expected<x86_instruction,std::string> parse_x86_instruction( std::span<const uint8_t> bytes, uint64_t address, std::pmr::memory_resource* resource ) {
+		auto instruction = decode_compact_instruction( bytes, address );
+		if ( !instruction ) {
+			return std::unexpected( instruction.error() );
+		}
+		return convert_to_instruction( instruction.value(), resource );
+	}
+
+	// ==============
+    //  Symbol Index
+    // ==============
+
+	constexpr uint32_t sht_dynsym = 11;
+
+	struct elf_symbol {
+		uint64_t address;
+		uint64_t end;
+		std::string name;
+		bool global;
+	};
+
+	std::string_view elf_symbol_name( const elf_file& elf, const elf64_shdr& table, const elf64_sym& symbol ) {
+		if ( table.sh_link >= elf.sections.size() ) {
+			return {};
+		}
+		return elf.string( elf.sections[ table.sh_link ], symbol.st_name );
+	}
+
+	// objdump's synthetic foo@plt symbols: each stub jumps through a GOT slot, and the
+	// relocation that fills the slot names the target.
+	void add_plt_symbols( const elf_file& elf, const elf64_shdr& plt, bool skip_header, std::vector<elf_symbol>& symbols ) {
+		std::unordered_map<uint64_t,std::string_view> slots;
+		for ( const auto& section : elf.sections ) {
+			if ( section.sh_type != sht_rela || section.sh_link >= elf.sections.size() ) {
+				continue;
+			}
+			const auto& table = elf.sections[ section.sh_link ];
+			auto table_symbols = elf.symbols( table );
+			for ( const auto& rela : elf.relocations( section ) ) {
+				uint64_t index = rela.r_info >> 32;
+				if ( index == 0 || index >= table_symbols.size() ) {
+					continue;
+				}
+				auto name = elf_symbol_name( elf, table, table_symbols[ index ] );
+				if ( !name.empty() ) {
+					slots.emplace( uint64_t{ rela.r_offset }, name );
+				}
+			}
+		}
+		uint64_t stub_size = plt.sh_entsize ? plt.sh_entsize : 16;
+		auto bytes = elf.contents( plt );
+		for ( uint64_t stub = skip_header ? stub_size : 0; stub < bytes.size(); stub += stub_size ) {
+			for ( uint64_t pos = stub; pos < std::min<uint64_t>( stub + stub_size, bytes.size() ); ) {
+				auto instruction = decode_compact_instruction( bytes.subspan( pos ), plt.sh_addr + pos );
+				if ( !instruction ) {
+					break;
+				}
+				pos += instruction->byte_count;
+				if ( instruction->mnemonic != x86_mnemonic::jmp || !instruction->has_operands() ||
+					 instruction->kind( 0 ) != x86_operand_kind::memory ) {
+					continue;
+				}
+				auto memory = std::get<x86_memory>( instruction->operand( 0 ) );
+				if ( memory.base != x86_register::rip || memory.index ) {
+					continue;
+				}
+				auto slot = slots.find( plt.sh_addr + pos + memory.displacement.value_or( 0 ) );
+				if ( slot != slots.end() ) {
+					symbols.push_back( { plt.sh_addr + stub, plt.sh_addr + stub + stub_size, std::string( slot->second ) + "@plt", true } );
+				}
+				break;
+			}
+		}
+	}
+
+	// Every defined function in .symtab and .dynsym plus the PLT stubs, sorted by address
+	// with one name per address, preferring global ones. A symbol ends at its st_size, or
+	// at its section's end when it has none, and never past the next symbol.
+	std::vector<elf_symbol> collect_elf_symbols( const elf_file& elf ) {
+		std::vector<elf_symbol> symbols;
+		for ( const auto& table : elf.sections ) {
+			if ( table.sh_type != sht_symtab && table.sh_type != sht_dynsym ) {
+				continue;
+			}
+			for ( const auto& symbol : elf.symbols( table ) ) {
+				if ( ( symbol.st_info & 0xf ) != stt_func || symbol.st_shndx == 0 || symbol.st_shndx >= elf.sections.size() ) {
+					continue;
+				}
+				const auto& section = elf.sections[ symbol.st_shndx ];
+				uint64_t end = symbol.st_size ? symbol.st_value + symbol.st_size : section.sh_addr + section.sh_size;
+				symbols.push_back( { symbol.st_value, end, std::string( elf_symbol_name( elf, table, symbol ) ),
+									 ( symbol.st_info >> 4 ) != stb_local } );
+			}
+		}
+		for ( const auto& section : elf.sections ) {
+			auto name = elf.section_name( section );
+			if ( name == ".plt" || name == ".plt.got" ) {
+				add_plt_symbols( elf, section, name == ".plt", symbols );
+			}
+		}
+
+		std::stable_sort( symbols.begin(), symbols.end(), []( const elf_symbol& lhs, const elf_symbol& rhs ) {
+			return lhs.address < rhs.address || ( lhs.address == rhs.address && lhs.global && !rhs.global );
+		} );
+		symbols.erase( std::unique( symbols.begin(), symbols.end(), []( const elf_symbol& lhs, const elf_symbol& rhs ) {
+			return lhs.address == rhs.address;
+		} ), symbols.end() );
+		for ( std::size_t i = 0; i + 1 < symbols.size(); ++i ) {
+			symbols[ i ].end = std::min( symbols[ i ].end, symbols[ i + 1 ].address );
+		}
+		return symbols;
+	}
+
+	symbol_entry symbol_index::operator[]( std::size_t i ) const {
+		return { starts[ i ], ends[ i ], std::string_view( names ).substr( name_offsets[ i ], name_offsets[ i + 1 ] - name_offsets[ i ] ) };
+	}
+
+	std::optional<symbol_entry> symbol_index::find( std::string_view name ) const {
+		auto it = std::lower_bound( by_name.begin(), by_name.end(), name, [ this ]( uint32_t i, std::string_view key ) {
+			return ( *this )[ i ].name < key;
+		} );
+		if ( it == by_name.end() || ( *this )[ *it ].name != name ) {
+			return std::nullopt;
+		}
+		return ( *this )[ *it ];
+	}
+
+	std::optional<symbol_entry> symbol_index::containing( uint64_t address ) const {
+		auto it = std::upper_bound( starts.begin(), starts.end(), address );
+		if ( it == starts.begin() ) {
+			return std::nullopt;
+		}
+		std::size_t i = static_cast<std::size_t>( it - starts.begin() ) - 1;
+		if ( address >= ends[ i ] ) {
+			return std::nullopt;
+		}
+		return ( *this )[ i ];
+	}
+
+	symbol_index build_symbol_index( const elf_file& elf ) {
+		auto symbols = collect_elf_symbols( elf );
+		symbol_index index;
+		index.starts.reserve( symbols.size() );
+		index.ends.reserve( symbols.size() );
+		index.name_offsets.reserve( symbols.size() + 1 );
+		index.name_offsets.push_back( 0 );
+		for ( const auto& symbol : symbols ) {
+			index.starts.push_back( symbol.address );
+			index.ends.push_back( symbol.end );
+			index.names += symbol.name;
+			index.name_offsets.push_back( static_cast<uint32_t>( index.names.size() ) );
+		}
+		index.by_name.resize( symbols.size() );
+		std::iota( index.by_name.begin(), index.by_name.end(), 0 );
+		std::sort( index.by_name.begin(), index.by_name.end(), [ & ]( uint32_t lhs, uint32_t rhs ) {
+			return symbols[ lhs ].name < symbols[ rhs ].name;
+		} );
+		return index;
+	}
+
+	// ===========
+    //  Parse Elf
+    // ===========
+
+	// The parts of an ELF image the decoders need: each code section's bytes with its
+	// function boundaries, sorted, one per address and the first at the section start.
+	struct elf_code_section {
+		uint64_t address = 0;
+		std::span<const uint8_t> bytes;
+		std::vector<elf_symbol> symbols;
+
+		bool contains( uint64_t target ) const {
+			return target >= address && target - address < bytes.size();
+		}
+	};
+
+	struct elf_code {
+		uint64_t entry = 0;
+		std::array<std::optional<elf_code_section>,5> sections;
+	};
+
+	std::expected<elf_code,std::string> load_elf_code( const elf_file& elf ) {
+		if ( elf.header->e_machine != em_x86_64 ) {
+			return std::unexpected( "Not an x86-64 ELF File" );
+		}
+		auto all_symbols = collect_elf_symbols( elf );
+		elf_code code;
+		code.entry = elf.header->e_entry;
+		for ( const auto& shdr : elf.sections ) {
+			auto section = get_elf_section( elf.section_name( shdr ) );
+			if ( section == elf_section::unknown ) {
+				continue;
+			}
+			if ( shdr.sh_type == sht_nobits ) {
+				return std::unexpected( "Invalid Section: " + std::string( elf.section_name( shdr ) ) );
+			}
+			auto first = std::lower_bound( all_symbols.begin(), all_symbols.end(), shdr.sh_addr, []( const elf_symbol& symbol, uint64_t address ) {
+				return symbol.address < address;
+			} );
+			auto last = std::lower_bound( first, all_symbols.end(), shdr.sh_addr + shdr.sh_size, []( const elf_symbol& symbol, uint64_t address ) {
+				return symbol.address < address;
+			} );
+			std::vector<elf_symbol> symbols( std::make_move_iterator( first ), std::make_move_iterator( last ) );
+			// A section that does not open on a symbol is labelled with its own name, as
+			// objdump does for .plt.
+			if ( symbols.empty() || symbols.front().address != shdr.sh_addr ) {
+				uint64_t end = symbols.empty() ? shdr.sh_addr + shdr.sh_size : symbols.front().address;
+				symbols.insert( symbols.begin(), { shdr.sh_addr, end, std::string( elf.section_name( shdr ) ), false } );
+			}
+			code.sections[ static_cast<std::size_t>( section ) ] = elf_code_section{ shdr.sh_addr, elf.contents( shdr ), std::move( symbols ) };
+		}
+		return code;
+	}
+
+	// Decodes only what control flow reaches from e_entry and the function symbols. A
+	// bitmap per section marks the bytes already decoded, so each reachable byte is
+	// decoded once and a path ends when it runs into decoded code, leaves the code
+	// sections or hits bytes that do not decode.
+	std::array<std::vector<x86_compact_instruction>,5> decode_reachable( const elf_code& code ) {
+		std::array<std::vector<x86_compact_instruction>,5> decoded;
+		std::array<std::vector<uint64_t>,5> visited;
+		std::vector<uint64_t> worklist{ code.entry };
+		for ( std::size_t s = 0; s < code.sections.size(); ++s ) {
+			if ( code.sections[ s ] ) {
+				visited[ s ].resize( ( code.sections[ s ]->bytes.size() + 63 ) / 64 );
+				for ( const auto& symbol : code.sections[ s ]->symbols ) {
+					worklist.push_back( symbol.address );
+				}
+			}
+		}
+		auto locate = [ & ]( uint64_t address ) -> std::size_t {
+			for ( std::size_t s = 0; s < code.sections.size(); ++s ) {
+				if ( code.sections[ s ] && code.sections[ s ]->contains( address ) ) {
+					return s;
+				}
+			}
+			return code.sections.size();
+		};
+		while ( !worklist.empty() ) {
+			uint64_t address = worklist.back();
+			worklist.pop_back();
+			for ( std::size_t s = locate( address ); s < code.sections.size(); ) {
+				const auto& section = *code.sections[ s ];
+				uint64_t offset = address - section.address;
+				auto& bits = visited[ s ];
+				if ( bits[ offset / 64 ] >> ( offset % 64 ) & 1 ) {
+					break;
+				}
+				x86_compact_instruction instruction;
+				if ( decode_into( section.bytes.subspan( offset ), address, instruction ) != decode_error::none ) {
+					break;
+				}
+				for ( uint64_t byte = offset; byte < offset + instruction.byte_count; ++byte ) {
+					bits[ byte / 64 ] |= uint64_t{ 1 } << ( byte % 64 );
+				}
+				decoded[ s ].push_back( instruction );
+				address += instruction.byte_count;
+
+				auto mnemonic = instruction.mnemonic;
+				bool branch = mnemonic == x86_mnemonic::call || mnemonic == x86_mnemonic::jmp ||
+							  mnemonic == x86_mnemonic::je || mnemonic == x86_mnemonic::jne;
+				if ( branch && instruction.kind( 0 ) == x86_operand_kind::address ) {
+					worklist.push_back( std::get<x86_address>( instruction.operand( 0 ) ).addr );
+				}
+				if ( mnemonic == x86_mnemonic::jmp || mnemonic == x86_mnemonic::ret || mnemonic == x86_mnemonic::hlt ) {
+					break;
+				}
+				if ( !section.contains( address ) ) {
+					s = locate( address );
+				}
+			}
+		}
+		for ( auto& instructions : decoded ) {
+			std::sort( instructions.begin(), instructions.end(), []( const x86_compact_instruction& lhs, const x86_compact_instruction& rhs ) {
+				return lhs.address < rhs.address;
+			} );
+		}
+		return decoded;
+	}
+
+	std::expected<elf64_x86_64,std::string> parse_elf( const elf_file& elf, disassembly_mode mode, std::pmr::memory_resource* resource ) {
+		auto code = load_elf_code( elf );
+		if ( !code ) {
+			return std::unexpected( code.error() );
+		}
+		std::array<std::vector<x86_compact_instruction>,5> reachable;
+		if ( mode == disassembly_mode::recursive_descent ) {
+			reachable = decode_reachable( code.value() );
+		}
+
+		elf64_x86_64 result;
+		for ( std::size_t s = 0; s < code->sections.size(); ++s ) {
+			if ( !code->sections[ s ] ) {
+				continue;
+			}
+			const auto& section = *code->sections[ s ];
+			auto& functions = *result.functions( static_cast<elf_section>( s ) );
+			auto* range = result.range( static_cast<elf_section>( s ) );
+			auto next = reachable[ s ].begin();
+			for ( std::size_t i = 0; i < section.symbols.size(); ++i ) {
+				const auto& symbol = section.symbols[ i ];
+				uint64_t end = i + 1 < section.symbols.size() ? section.symbols[ i + 1 ].address : section.address + section.bytes.size();
+				auto& func = functions.emplace_back( resource );
+				func.name = symbol.name;
+				if ( mode == disassembly_mode::recursive_descent ) {
+					for ( ; next != reachable[ s ].end() && next->address < end; ++next ) {
+						range->extend( func.instructions.emplace_back( convert_to_instruction( *next, resource ) ) );
+					}
+					if ( func.instructions.empty() ) {
+						functions.pop_back();
+					}
+					continue;
+				}
+				for ( uint64_t address = symbol.address; address < end; ) {
+					auto instruction = parse_x86_instruction( section.bytes.subspan( address - section.address ), address, resource );
+					if ( !instruction ) {
+						return std::unexpected( instruction.error() + " in " + symbol.name + " at offset " +
+												std::to_string( address - symbol.address ) );
+					}
+					address += instruction->machine_bytes.size();
+					range->extend( instruction.value() );
+					func.instructions.push_back( std::move( instruction.value() ) );
+				}
+			}
+		}
+		return result;
+	}
+
+	std::expected<elf64_x86_64,std::string> parse_elf( std::span<const uint8_t> image, disassembly_mode mode, std::pmr::memory_resource* resource ) {
+		auto elf = open_elf_image( image );
+		if ( !elf ) {
+			return std::unexpected( elf.error() );
+		}
+		return parse_elf( elf.value(), mode, resource );
+	}
+
+	std::expected<elf64_x86_64,std::string> parse_elf( const std::string& file_name, disassembly_mode mode, std::pmr::memory_resource* resource ) {
+		auto elf = open_elf_file( file_name );
+		if ( !elf ) {
+			return std::unexpected( elf.error() );
+		}
+		return parse_elf( elf.value(), mode, resource );
 	}
 
 	// ============================
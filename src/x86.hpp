@@ -2,18 +2,31 @@
 #define X86_HPP
 
 #include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cctype>
 #include <charconv>
 #include <cstdint>
+#include <cstdio>
 #include <cstring>
 #include <expected>
 #include <fstream>
 #include <iostream>
+#include <limits>
+#include <memory>
+#include <memory_resource>
+#include <numeric>
 #include <optional>
-#include <regex>
-#include <stack>
+#include <span>
 #include <sstream>
 #include <string>
+#include <string_view>
+#include <thread>
+#include <type_traits>
 #include <unordered_map>
+#include <utility>
+#include <variant>
 #include <vector>
 
 namespace stig {
@@ -48,12 +61,36 @@ namespace stig {
 	    uint64_t sh_entsize;
 	};
 
+	struct __attribute__((packed)) elf64_phdr {
+	    uint32_t p_type;
+	    uint32_t p_flags;
+	    uint64_t p_offset;
+	    uint64_t p_vaddr;
+	    uint64_t p_paddr;
+	    uint64_t p_filesz;
+	    uint64_t p_memsz;
+	    uint64_t p_align;
+	};
+
+	struct __attribute__((packed)) elf64_sym {
+	    uint32_t st_name;
+	    unsigned char st_info;
+	    unsigned char st_other;
+	    uint16_t st_shndx;
+	    uint64_t st_value;
+	    uint64_t st_size;
+	};
+
+	struct __attribute__((packed)) elf64_rela {
+	    uint64_t r_offset;
+	    uint64_t r_info;
+	    int64_t r_addend;
+	};
+
 	std::expected<elf64_ehdr,std::string> get_elf_header( const std::string& file_name );
 
 	std::expected<std::vector<elf64_shdr>,std::string> parse_elf64_shdr( std::ifstream& file, elf64_ehdr& hdr );
 
-	inline std::regex func_name_regex( R"(^[0-9A-Fa-f]{16}\s+<([^>]+)>)" );
-
 	namespace file_format {
 		inline std::string x_86_64 = "file format elf64-x86-64";
 	};
@@ -84,109 +121,221 @@ namespace stig {
 		sar,
 		shr,
 		test,
-		xor_
-	};
-
-	inline const std::unordered_map<x86_mnemonic,std::string> mnemonic_names = {
-    	{ x86_mnemonic::endbr64, "endbr64" },
-	    { x86_mnemonic::push,       "push" },
-	    { x86_mnemonic::mov,         "mov" },
-	    { x86_mnemonic::pop,         "pop" },
-	    { x86_mnemonic::ret,         "ret" },
-	    { x86_mnemonic::nopl,       "nopl" },
-	    { x86_mnemonic::movb,       "movb" },
-	    { x86_mnemonic::call,       "call" },
-	    { x86_mnemonic::cmpq,       "cmpq" },
-	    { x86_mnemonic::lea,         "lea" },
-	    { x86_mnemonic::sar,         "sar" },
-	    { x86_mnemonic::je,           "je" },
-	    { x86_mnemonic::add,         "add" },
-	    { x86_mnemonic::sub,         "sub" },
-	    { x86_mnemonic::jmp,         "jmp" },
-	    { x86_mnemonic::cmpb,       "cmpb" },
-	    { x86_mnemonic::jne, 		 "jne" },
-	    { x86_mnemonic::padding, "padding" },
-	    { x86_mnemonic::shr,         "shr" },
-	    { x86_mnemonic::test,       "test" },
-	  	{ x86_mnemonic::nopw,       "nopw" },
-	  	{ x86_mnemonic::cmp,         "cmp" },
-	  	{ x86_mnemonic::xor_,        "xor" },
-	  	{ x86_mnemonic::and_,        "and" },
-	  	{ x86_mnemonic::hlt,         "hlt" },
-	  	{ x86_mnemonic::cmpxchg, "cmpxchg" }    
-    };
-
-    static const std::unordered_map<std::string, x86_mnemonic> mnemonic_map = {
-    	{ "add",         x86_mnemonic::add },
-	    { "endbr64", x86_mnemonic::endbr64 },
-	    { "push",       x86_mnemonic::push },
-	    { "mov",         x86_mnemonic::mov },
-	    { "pop",         x86_mnemonic::pop },
-	    { "ret",         x86_mnemonic::ret },
-	    { "nopl",       x86_mnemonic::nopl },
-	    { "movb",       x86_mnemonic::movb },
-	    { "call",       x86_mnemonic::call },
-	    { "cmpq",       x86_mnemonic::cmpq },
-	    { "lea",         x86_mnemonic::lea },
-	    { "sar",         x86_mnemonic::sar },
-	    { "je",           x86_mnemonic::je },
-	    { "sub",         x86_mnemonic::sub },
-	    { "jmp",         x86_mnemonic::jmp },
-	    { "cmpb",       x86_mnemonic::cmpb },
-	    { "jne",         x86_mnemonic::jne },
-	    { "padding", x86_mnemonic::padding },
-	    { "shr",         x86_mnemonic::shr },
-	    { "test",       x86_mnemonic::test },
-	    { "nopw",       x86_mnemonic::nopw },
-	    { "cmp",         x86_mnemonic::cmp },
-	    { "xor",        x86_mnemonic::xor_ },
-	    { "and",        x86_mnemonic::and_ },
-	    { "hlt",         x86_mnemonic::hlt },
-	    { "cmpxchg", x86_mnemonic::cmpxchg }
+		xor_,
+		nop,
+		xchg
+	};
+
+	// One row per mnemonic, in enum order. mnemonic_names, mnemonic_table and the byte
+	// decoder's size-suffixed spellings (cmp on a byte in memory is cmpb) are all
+	// generated from this list.
+	struct x86_mnemonic_info {
+		x86_mnemonic mnemonic;
+		std::string_view name;
+		std::optional<x86_mnemonic> base = std::nullopt;
+		uint8_t width = 0;
 	};
 
+	inline constexpr std::array<x86_mnemonic_info,28> mnemonic_infos = { {
+		{ x86_mnemonic::add,         "add" },
+		{ x86_mnemonic::and_,        "and" },
+		{ x86_mnemonic::call,       "call" },
+		{ x86_mnemonic::cmp,         "cmp" },
+		{ x86_mnemonic::cmpb,       "cmpb", x86_mnemonic::cmp, 8 },
+		{ x86_mnemonic::cmpq,       "cmpq", x86_mnemonic::cmp, 64 },
+		{ x86_mnemonic::cmpxchg, "cmpxchg" },
+		{ x86_mnemonic::endbr64, "endbr64" },
+		{ x86_mnemonic::hlt,         "hlt" },
+		{ x86_mnemonic::je,           "je" },
+		{ x86_mnemonic::jne,         "jne" },
+		{ x86_mnemonic::jmp,         "jmp" },
+		{ x86_mnemonic::lea,         "lea" },
+		{ x86_mnemonic::mov,         "mov" },
+		{ x86_mnemonic::movb,       "movb", x86_mnemonic::mov, 8 },
+		{ x86_mnemonic::padding, "padding" },
+		{ x86_mnemonic::nopl,       "nopl", x86_mnemonic::nopl, 32 },
+		{ x86_mnemonic::nopw,       "nopw", x86_mnemonic::nopl, 16 },
+		{ x86_mnemonic::pop,         "pop" },
+		{ x86_mnemonic::push,       "push" },
+		{ x86_mnemonic::ret,         "ret" },
+		{ x86_mnemonic::sub,         "sub" },
+		{ x86_mnemonic::sar,         "sar" },
+		{ x86_mnemonic::shr,         "shr" },
+		{ x86_mnemonic::test,       "test" },
+		{ x86_mnemonic::xor_,        "xor" },
+		{ x86_mnemonic::nop,         "nop" },
+		{ x86_mnemonic::xchg,       "xchg" }
+	} };
+
+	static_assert( [] {
+		for ( std::size_t i = 0; i < mnemonic_infos.size(); ++i ) {
+			if ( static_cast<std::size_t>( mnemonic_infos[ i ].mnemonic ) != i ) {
+				return false;
+			}
+		}
+		return true;
+	}(), "mnemonic_infos must list every x86_mnemonic in enum order" );
+
+	constexpr std::string_view mnemonic_name( x86_mnemonic mnemonic ) {
+		return mnemonic_infos[ static_cast<std::size_t>( mnemonic ) ].name;
+	}
+
+	inline const std::unordered_map<x86_mnemonic,std::string> mnemonic_names = [] {
+		std::unordered_map<x86_mnemonic,std::string> names;
+		for ( const auto& info : mnemonic_infos ) {
+			names.emplace( info.mnemonic, info.name );
+		}
+		return names;
+	}();
+
+	// =====================
+	//  Perfect Hash Tables
+	// =====================
+
+	constexpr uint64_t perfect_hash( std::string_view key, uint64_t seed ) {
+		uint64_t hash = 0xcbf29ce484222325ull ^ ( seed * 0x9e3779b97f4a7c15ull );
+		for ( char c : key ) {
+			hash ^= static_cast<uint8_t>( c );
+			hash *= 0x100000001b3ull;
+		}
+		return hash ^ ( hash >> 29 );
+	}
+
+	// Open-addressing-free lookup table: the constructor searches for a seed under
+	// which every key lands in its own slot, so a lookup is one hash, one load and
+	// one string compare.
+	template<typename T, std::size_t N>
+	struct perfect_hash_table {
+		static_assert( N < 0xff, "perfect_hash_table slots are uint8_t indices" );
+
+		static constexpr std::size_t slot_count = std::bit_ceil( N * 8 );
+		static constexpr uint8_t empty = 0xff;
+
+		std::array<std::string_view,N> keys{};
+		std::array<T,N> values{};
+		std::array<uint8_t,slot_count> slots{};
+		uint64_t seed = 0;
+
+		constexpr perfect_hash_table( const std::array<std::pair<std::string_view,T>,N>& entries ) {
+			for ( std::size_t i = 0; i < N; ++i ) {
+				keys[ i ] = entries[ i ].first;
+				values[ i ] = entries[ i ].second;
+			}
+			for ( ; ; ++seed ) {
+				if ( seed == 1 << 16 ) {
+					throw "perfect_hash_table: no seed found, check for duplicate keys";
+				}
+				slots.fill( empty );
+				bool collision = false;
+				for ( std::size_t i = 0; i < N && !collision; ++i ) {
+					auto& slot = slots[ perfect_hash( keys[ i ], seed ) & ( slot_count - 1 ) ];
+					collision = slot != empty;
+					slot = static_cast<uint8_t>( i );
+				}
+				if ( !collision ) {
+					return;
+				}
+			}
+		}
+
+		constexpr std::optional<T> find( std::string_view key ) const {
+			uint8_t index = slots[ perfect_hash( key, seed ) & ( slot_count - 1 ) ];
+			if ( index == empty || keys[ index ] != key ) {
+				return std::nullopt;
+			}
+			return values[ index ];
+		}
+	};
+
+	inline constexpr perfect_hash_table<x86_mnemonic,mnemonic_infos.size()> mnemonic_table = [] {
+		std::array<std::pair<std::string_view,x86_mnemonic>,mnemonic_infos.size()> entries{};
+		for ( std::size_t i = 0; i < mnemonic_infos.size(); ++i ) {
+			entries[ i ] = { mnemonic_infos[ i ].name, mnemonic_infos[ i ].mnemonic };
+		}
+		return perfect_hash_table<x86_mnemonic,mnemonic_infos.size()>( entries );
+	}();
+
+	constexpr std::optional<x86_mnemonic> get_mnemonic( std::string_view token ) {
+		return mnemonic_table.find( token );
+	}
+
+	// General purpose registers are listed in hardware encoding order within each
+	// width, so the low bits of ModRM/REX register numbers index straight into a group.
 	enum class x86_register : uint8_t {
-		eax,
-		ebp,
-		edx,
-		edi,
-		esi,
-		rax,
-		rbp,
-		rdi,
-		rdx,
-		rip,
-		rsi,
-		rsp,
-		r8, 
-		r9, 
-		r10, 
-		r11, 
-		r12, 
-		r13, 
-		r14, 
-		r15
+		rax, rcx, rdx, rbx, rsp, rbp, rsi, rdi,
+		r8, r9, r10, r11, r12, r13, r14, r15,
+		eax, ecx, edx, ebx, esp, ebp, esi, edi,
+		r8d, r9d, r10d, r11d, r12d, r13d, r14d, r15d,
+		ax, cx, dx, bx, sp, bp, si, di,
+		r8w, r9w, r10w, r11w, r12w, r13w, r14w, r15w,
+		al, cl, dl, bl, spl, bpl, sil, dil,
+		r8b, r9b, r10b, r11b, r12b, r13b, r14b, r15b,
+		ah, ch, dh, bh,
+		rip, eip,
+		es, cs, ss, ds, fs, gs,
+		xmm0, xmm1, xmm2, xmm3, xmm4, xmm5, xmm6, xmm7,
+		xmm8, xmm9, xmm10, xmm11, xmm12, xmm13, xmm14, xmm15
 	};
 
+	inline constexpr perfect_hash_table<x86_register,92> register_table{ { {
+		{ "%rax", x86_register::rax }, { "%rcx", x86_register::rcx }, { "%rdx", x86_register::rdx }, { "%rbx", x86_register::rbx },
+		{ "%rsp", x86_register::rsp }, { "%rbp", x86_register::rbp }, { "%rsi", x86_register::rsi }, { "%rdi", x86_register::rdi },
+		{ "%r8",  x86_register::r8 },  { "%r9",  x86_register::r9 },  { "%r10", x86_register::r10 }, { "%r11", x86_register::r11 },
+		{ "%r12", x86_register::r12 }, { "%r13", x86_register::r13 }, { "%r14", x86_register::r14 }, { "%r15", x86_register::r15 },
+		{ "%eax", x86_register::eax }, { "%ecx", x86_register::ecx }, { "%edx", x86_register::edx }, { "%ebx", x86_register::ebx },
+		{ "%esp", x86_register::esp }, { "%ebp", x86_register::ebp }, { "%esi", x86_register::esi }, { "%edi", x86_register::edi },
+		{ "%r8d",  x86_register::r8d },  { "%r9d",  x86_register::r9d },  { "%r10d", x86_register::r10d }, { "%r11d", x86_register::r11d },
+		{ "%r12d", x86_register::r12d }, { "%r13d", x86_register::r13d }, { "%r14d", x86_register::r14d }, { "%r15d", x86_register::r15d },
+		{ "%ax", x86_register::ax }, { "%cx", x86_register::cx }, { "%dx", x86_register::dx }, { "%bx", x86_register::bx },
+		{ "%sp", x86_register::sp }, { "%bp", x86_register::bp }, { "%si", x86_register::si }, { "%di", x86_register::di },
+		{ "%r8w",  x86_register::r8w },  { "%r9w",  x86_register::r9w },  { "%r10w", x86_register::r10w }, { "%r11w", x86_register::r11w },
+		{ "%r12w", x86_register::r12w }, { "%r13w", x86_register::r13w }, { "%r14w", x86_register::r14w }, { "%r15w", x86_register::r15w },
+		{ "%al",  x86_register::al },  { "%cl",  x86_register::cl },  { "%dl",  x86_register::dl },  { "%bl",  x86_register::bl },
+		{ "%spl", x86_register::spl }, { "%bpl", x86_register::bpl }, { "%sil", x86_register::sil }, { "%dil", x86_register::dil },
+		{ "%r8b",  x86_register::r8b },  { "%r9b",  x86_register::r9b },  { "%r10b", x86_register::r10b }, { "%r11b", x86_register::r11b },
+		{ "%r12b", x86_register::r12b }, { "%r13b", x86_register::r13b }, { "%r14b", x86_register::r14b }, { "%r15b", x86_register::r15b },
+		{ "%ah", x86_register::ah }, { "%ch", x86_register::ch }, { "%dh", x86_register::dh }, { "%bh", x86_register::bh },
+		{ "%rip", x86_register::rip }, { "%eip", x86_register::eip },
+		{ "%es", x86_register::es }, { "%cs", x86_register::cs }, { "%ss", x86_register::ss },
+		{ "%ds", x86_register::ds }, { "%fs", x86_register::fs }, { "%gs", x86_register::gs },
+		{ "%xmm0",  x86_register::xmm0 },  { "%xmm1",  x86_register::xmm1 },  { "%xmm2",  x86_register::xmm2 },  { "%xmm3",  x86_register::xmm3 },
+		{ "%xmm4",  x86_register::xmm4 },  { "%xmm5",  x86_register::xmm5 },  { "%xmm6",  x86_register::xmm6 },  { "%xmm7",  x86_register::xmm7 },
+		{ "%xmm8",  x86_register::xmm8 },  { "%xmm9",  x86_register::xmm9 },  { "%xmm10", x86_register::xmm10 }, { "%xmm11", x86_register::xmm11 },
+		{ "%xmm12", x86_register::xmm12 }, { "%xmm13", x86_register::xmm13 }, { "%xmm14", x86_register::xmm14 }, { "%xmm15", x86_register::xmm15 }
+	} } };
+
+	constexpr std::optional<x86_register> get_register( std::string_view token ) {
+		return register_table.find( token );
+	}
+
 	inline std::expected<int,std::string> get_register_width( const x86_register reg ) {
-	    switch ( reg ) {
-	        case x86_register::rax:
-	        case x86_register::rbp:
-	        case x86_register::rdi:
-	        case x86_register::rip:
-	        case x86_register::rsi:
-	        case x86_register::rsp:
-	        case x86_register::r8:
-	        	return 64;
-	        case x86_register::eax: 
-	        case x86_register::ebp: 
-	        case x86_register::edx:
-	        case x86_register::edi:
-	        case x86_register::esi:
-	        	return 32;
-	        default:
-	        	return std::unexpected( "Register Width not found" );
-	    }
+		if ( reg <= x86_register::r15 ) {
+			return 64;
+		}
+		if ( reg <= x86_register::r15d ) {
+			return 32;
+		}
+		if ( reg <= x86_register::r15w ) {
+			return 16;
+		}
+		if ( reg <= x86_register::bh ) {
+			return 8;
+		}
+		switch ( reg ) {
+			case x86_register::rip:
+				return 64;
+			case x86_register::eip:
+				return 32;
+			case x86_register::es:
+			case x86_register::cs:
+			case x86_register::ss:
+			case x86_register::ds:
+			case x86_register::fs:
+			case x86_register::gs:
+				return 16;
+			default:
+				return 128;
+		}
 	}
 
 	struct x86_immediate {
@@ -221,11 +370,58 @@ namespace stig {
 
 	using x86_operand = std::variant<x86_register,x86_immediate,x86_memory,x86_address>;
 
+	// Allocator-aware so a std::pmr container of instructions hands its memory resource
+	// down to machine_bytes and operands; a whole parse can then live in one arena.
 	struct x86_instruction {
-		uint64_t address;
-		std::vector<uint8_t> machine_bytes;
-		x86_mnemonic mnemonic;
-		std::optional<std::vector<x86_operand>> operands;
+		using allocator_type = std::pmr::polymorphic_allocator<>;
+
+		uint64_t address = 0;
+		std::pmr::vector<uint8_t> machine_bytes;
+		x86_mnemonic mnemonic{};
+		std::optional<std::pmr::vector<x86_operand>> operands;
+
+		x86_instruction() = default;
+
+		explicit x86_instruction( allocator_type alloc ) : machine_bytes( alloc ) {}
+
+		x86_instruction( uint64_t address, std::initializer_list<uint8_t> machine_bytes, x86_mnemonic mnemonic,
+						 const std::optional<std::vector<x86_operand>>& operands, allocator_type alloc = {} )
+			: address( address ), machine_bytes( machine_bytes, alloc ), mnemonic( mnemonic ) {
+			if ( operands ) {
+				this->operands.emplace( operands->begin(), operands->end(), alloc );
+			}
+		}
+
+		x86_instruction( uint64_t address, const std::vector<uint8_t>& machine_bytes, x86_mnemonic mnemonic,
+						 const std::optional<std::vector<x86_operand>>& operands, allocator_type alloc = {} )
+			: address( address ), machine_bytes( machine_bytes.begin(), machine_bytes.end(), alloc ), mnemonic( mnemonic ) {
+			if ( operands ) {
+				this->operands.emplace( operands->begin(), operands->end(), alloc );
+			}
+		}
+
+		x86_instruction( const x86_instruction& ) = default;
+		x86_instruction( x86_instruction&& ) = default;
+		x86_instruction& operator=( const x86_instruction& ) = default;
+		x86_instruction& operator=( x86_instruction&& ) = default;
+
+		x86_instruction( const x86_instruction& other, allocator_type alloc )
+			: address( other.address ), machine_bytes( other.machine_bytes, alloc ), mnemonic( other.mnemonic ) {
+			if ( other.operands ) {
+				operands.emplace( other.operands.value(), alloc );
+			}
+		}
+
+		x86_instruction( x86_instruction&& other, allocator_type alloc )
+			: address( other.address ), machine_bytes( std::move( other.machine_bytes ), alloc ), mnemonic( other.mnemonic ) {
+			if ( other.operands ) {
+				operands.emplace( std::move( other.operands.value() ), alloc );
+			}
+		}
+
+		allocator_type get_allocator() const {
+			return machine_bytes.get_allocator();
+		}
 
 		bool operator==( const x86_instruction& other ) const {
 			return address == other.address &&
@@ -242,8 +438,32 @@ namespace stig {
 	};
 
 	struct function {
-		std::string name;
-		std::vector<x86_instruction> instructions;
+		using allocator_type = std::pmr::polymorphic_allocator<>;
+
+		std::pmr::string name;
+		std::pmr::vector<x86_instruction> instructions;
+
+		function() = default;
+
+		explicit function( allocator_type alloc ) : name( alloc ), instructions( alloc ) {}
+
+		function( std::string_view name, std::initializer_list<x86_instruction> instructions, allocator_type alloc = {} )
+			: name( name, alloc ), instructions( instructions, alloc ) {}
+
+		function( const function& ) = default;
+		function( function&& ) = default;
+		function& operator=( const function& ) = default;
+		function& operator=( function&& ) = default;
+
+		function( const function& other, allocator_type alloc )
+			: name( other.name, alloc ), instructions( other.instructions, alloc ) {}
+
+		function( function&& other, allocator_type alloc )
+			: name( std::move( other.name ), alloc ), instructions( std::move( other.instructions ), alloc ) {}
+
+		allocator_type get_allocator() const {
+			return instructions.get_allocator();
+		}
 
 		bool operator==( const function& other ) const {
 			return name == other.name &&
@@ -253,12 +473,47 @@ namespace stig {
 	};
 
 	struct program {
-		uint64_t entry_point;
-		std::unordered_map<uint64_t,x86_instruction> instrs;
-		uint64_t exit_point;
+		uint64_t entry_point = 0;
+		std::pmr::unordered_map<uint64_t,x86_instruction> instrs;
+		uint64_t exit_point = 0;
+	};
+
+	std::expected<program,std::string> convert_to_program( function& func, std::pmr::memory_resource* resource = std::pmr::get_default_resource() );
+
+	enum class elf_section : uint8_t {
+		init,
+		plt,
+		plt_got,
+		text,
+		fini,
+		unknown
 	};
 
-	std::expected<program,std::string> convert_to_program( function& func );
+	elf_section get_elf_section( std::string_view section_name );
+
+	struct address_range {
+		uint64_t begin;
+		uint64_t end;
+
+		bool contains( const uint64_t address ) const {
+			return address >= begin && address < end;
+		}
+
+		void extend( const x86_instruction& instruction ) {
+			uint64_t instruction_end = instruction.address + instruction.machine_bytes.size();
+			if ( begin == end ) {
+				begin = instruction.address;
+				end = instruction_end;
+				return;
+			}
+			begin = std::min( begin, instruction.address );
+			end = std::max( end, instruction_end );
+		}
+
+		bool operator==( const address_range& other ) const {
+			return begin == other.begin && end == other.end;
+		}
+	};
 
 	struct elf64_x86_64 {
 		std::vector<function> _init;
@@ -266,10 +521,183 @@ namespace stig {
 		std::vector<function> plt_got;
 		std::vector<function> text;
 		std::vector<function> fini;
+		std::array<address_range,5> ranges{};
+
+		std::vector<function>* functions( const elf_section section ) {
+			switch ( section ) {
+				case elf_section::init:
+					return &_init;
+				case elf_section::plt:
+					return &plt;
+				case elf_section::plt_got:
+					return &plt_got;
+				case elf_section::text:
+					return &text;
+				case elf_section::fini:
+					return &fini;
+				default:
+					return nullptr;
+			}
+		}
+
+		const std::vector<function>* functions( const elf_section section ) const {
+			return const_cast<elf64_x86_64*>( this )->functions( section );
+		}
+
+		address_range* range( const elf_section section ) {
+			if ( section == elf_section::unknown ) {
+				return nullptr;
+			}
+			return &ranges[ static_cast<std::size_t>( section ) ];
+		}
+
+		const address_range* range( const elf_section section ) const {
+			return const_cast<elf64_x86_64*>( this )->range( section );
+		}
+	};
+
+	const function* find_function( const elf64_x86_64& elf, uint64_t address );
+
+	// ======================
+	//  Compact Instructions
+	// ======================
+
+	// Matches the alternative order of x86_operand, so a kind is the variant's index().
+	enum class x86_operand_kind : uint8_t {
+		reg,
+		immediate,
+		memory,
+		address
 	};
 
+	// Fixed-size, trivially copyable form of x86_instruction that fills exactly one cache
+	// line. Operands are stored column-wise so their 64-bit values stay aligned; each slot
+	// keeps its kind and, for memory operands, which parts are present in operand_flags.
+	struct alignas( 64 ) x86_compact_instruction {
+		static constexpr std::size_t max_bytes = 15;
+		static constexpr std::size_t max_operands = 3;
+		static constexpr uint8_t no_operands = 0xff;
+
+		static constexpr uint8_t kind_mask = 0b11;
+		static constexpr uint8_t has_base = 1 << 2;
+		static constexpr uint8_t has_index = 1 << 3;
+		static constexpr uint8_t has_scale = 1 << 4;
+		static constexpr uint8_t has_displacement = 1 << 5;
+
+		uint64_t address = 0;
+		std::array<int64_t,max_operands> values{};   // immediate, address or displacement
+		std::array<uint8_t,max_bytes> machine_bytes{};
+		uint8_t byte_count = 0;
+		x86_mnemonic mnemonic{};
+		uint8_t operand_count = no_operands;   // no_operands when std::nullopt
+		std::array<uint8_t,max_operands> operand_flags{};
+		std::array<x86_register,max_operands> regs{};   // register operand or memory base
+		std::array<x86_register,max_operands> indexes{};
+		std::array<uint8_t,max_operands> scales{};
+
+		std::span<const uint8_t> bytes() const {
+			return { machine_bytes.data(), byte_count };
+		}
+
+		bool has_operands() const {
+			return operand_count != no_operands;
+		}
+
+		std::size_t operands_size() const {
+			return has_operands() ? operand_count : 0;
+		}
+
+		x86_operand_kind kind( std::size_t i ) const {
+			return static_cast<x86_operand_kind>( operand_flags[ i ] & kind_mask );
+		}
+
+		x86_operand operand( std::size_t i ) const;
+
+		// Returns false when all max_operands slots are taken.
+		bool push_operand( const x86_operand& operand );
+
+		bool operator==( const x86_compact_instruction& other ) const = default;
+	};
+
+	static_assert( sizeof( x86_compact_instruction ) == 64 && std::is_trivially_copyable_v<x86_compact_instruction> );
+
+	struct compact_function {
+		std::pmr::string name;
+		std::pmr::vector<x86_compact_instruction> instructions;
+
+		bool operator==( const compact_function& other ) const = default;
+	};
+
+	std::expected<x86_compact_instruction,std::string> convert_to_compact( const x86_instruction& instruction );
+
+	std::expected<compact_function,std::string> convert_to_compact( const function& func, std::pmr::memory_resource* resource = std::pmr::get_default_resource() );
+
+	x86_instruction convert_to_instruction( const x86_compact_instruction& instruction, std::pmr::memory_resource* resource = std::pmr::get_default_resource() );
+
+	function convert_to_function( const compact_function& func, std::pmr::memory_resource* resource = std::pmr::get_default_resource() );
+
+	std::expected<x86_compact_instruction,std::string> parse_compact_instruction( std::string_view line );
+
+	std::expected<compact_function,std::string> parse_compact_function( std::string_view text, std::pmr::memory_resource* resource = std::pmr::get_default_resource() );
+
+	// ===================
+	//  Instruction Store
+	// ===================
+
+	// Structure-of-arrays store for every instruction of a binary. Each column is dense,
+	// so a scan over one field (e.g. every mnemonic) streams only that field. Operand
+	// columns are laid out like the slots of x86_compact_instruction.
+	struct instruction_store {
+		// One entry per instruction.
+		std::vector<uint64_t> addresses;
+		std::vector<x86_mnemonic> mnemonics;
+		std::vector<uint32_t> byte_offsets;
+		std::vector<uint8_t> byte_counts;
+		std::vector<uint32_t> operand_offsets;
+		std::vector<uint8_t> operand_counts;   // x86_compact_instruction::no_operands when std::nullopt
+
+		// One entry per operand.
+		std::vector<int64_t> operand_values;
+		std::vector<uint8_t> operand_flags;
+		std::vector<x86_register> operand_regs;
+		std::vector<x86_register> operand_indexes;
+		std::vector<uint8_t> operand_scales;
+
+		std::vector<uint8_t> bytes;
+
+		// One entry per function; function i owns instructions [ function_offsets[ i ], function_offsets[ i + 1 ] ).
+		std::vector<uint32_t> function_offsets;
+		std::vector<elf_section> function_sections;
+		std::vector<std::string> function_names;
+
+		std::size_t size() const {
+			return addresses.size();
+		}
+
+		std::size_t function_count() const {
+			return function_offsets.size();
+		}
+
+		void add_function( std::string_view name, elf_section section );
+
+		void push_back( const x86_compact_instruction& instruction );
+
+		x86_compact_instruction compact( std::size_t i ) const;
+
+		// Indices of every instruction with the given mnemonic, in file order.
+		std::vector<uint32_t> find( x86_mnemonic mnemonic ) const;
+
+		std::vector<uint64_t> addresses_of( x86_mnemonic mnemonic ) const;
+
+		std::size_t count( x86_mnemonic mnemonic ) const;
+	};
+
+	std::expected<instruction_store,std::string> build_instruction_store( const elf64_x86_64& elf );
+
 	std::expected<x86_instruction_parse_result,std::string> parse_x86_instruction( std::string instruction );
 
+	std::expected<x86_instruction,std::string> parse_x86_instruction_view( std::string_view line, std::pmr::memory_resource* resource = std::pmr::get_default_resource() );
+
 	std::expected<x86_instruction_parse_result,std::string> parse_address( x86_instruction_parse_result p_result );
 
 	std::expected<x86_instruction_parse_result,std::string> extract_machine_bytes( x86_instruction_parse_result p_result );
@@ -280,28 +708,26 @@ namespace stig {
 
 	std::expected<x86_memory,std::string> get_memory( const std::string& token );
 
-	std::expected<function,std::string> parse_function( const std::string& token );
+	std::expected<function,std::string> parse_function( std::string_view text, std::pmr::memory_resource* resource = std::pmr::get_default_resource() );
 
 	//std::ostream& operator<<( std::ostream& os, x86_instruction instruction );
 
 	struct x86_cpu {
-		int64_t rax;
-		int64_t rbp;
-		int64_t	rdi;
-		int64_t rdx;
-		int64_t	rip;
-		int64_t	rsi;
-		int64_t	rsp;
-		int64_t r8; 
-		int64_t r9; 
-		int64_t r10; 
-		int64_t r11; 
-		int64_t r12; 
-		int64_t r13; 
-		int64_t r14; 
-		int64_t r15;
-
-		std::stack<uint8_t> stack;
+		int64_t rax = 0;
+		int64_t rbp = 0;
+		int64_t rdi = 0;
+		int64_t rdx = 0;
+		int64_t rip = 0;
+		int64_t rsi = 0;
+		int64_t rsp = 0;
+		int64_t r8 = 0;
+		int64_t r9 = 0;
+		int64_t r10 = 0;
+		int64_t r11 = 0;
+		int64_t r12 = 0;
+		int64_t r13 = 0;
+		int64_t r14 = 0;
+		int64_t r15 = 0;
 
 		void increment_rpi( const int val ) {
 			rip += val;
@@ -320,6 +746,8 @@ namespace stig {
 					return static_cast<uint32_t>( rdx );
 				case x86_register::rax:
 					return static_cast<uint64_t>( rax );
+				case x86_register::rbp:
+					return static_cast<uint64_t>( rbp );
 				case x86_register::rdi:
 					return static_cast<uint64_t>( rdi );
 				case x86_register::rdx:
@@ -353,6 +781,10 @@ namespace stig {
             		rax = static_cast<int64_t>( static_cast<uint64_t>( val ) );
             		return {};
             	}
+            	case x86_register::rbp: {
+            		rbp = static_cast<int64_t>( static_cast<uint64_t>( val ) );
+            		return {};
+            	}
             	case x86_register::rdi: {
             		rdi = static_cast<int64_t>( static_cast<uint64_t>( val ) );
             		return {};
@@ -384,18 +816,80 @@ namespace stig {
 
 	};
 
+	enum segment_flags : uint32_t {
+		segment_execute = 1 << 0,
+		segment_write = 1 << 1,
+		segment_read = 1 << 2
+	};
+
+	// A PT_LOAD segment. Its file bytes are borrowed from the ELF image and read in place;
+	// the first write to a page copies it into pages, and bytes past the file image read
+	// as zero until written, so an untouched .bss costs nothing.
+	struct guest_segment {
+		uint64_t address = 0;
+		uint64_t size = 0;                             // p_memsz
+		std::span<const uint8_t> file_bytes;           // p_filesz bytes
+		uint32_t flags = 0;
+		std::vector<std::unique_ptr<uint8_t[]>> pages;  // written pages, indexed from address
+
+		bool contains( uint64_t target ) const {
+			return target >= address && target - address < size;
+		}
+	};
+
+	// The guest stack: one contiguous block below top, addressed by rsp and growing down.
+	// Only the part rsp has reached is allocated, doubling as it grows, up to limit;
+	// addresses below it but within limit read as zero.
+	struct guest_stack {
+		static constexpr uint64_t top = 0x7ffffffff000;
+		static constexpr uint64_t limit = uint64_t{ 8 } << 20;
+
+		std::vector<uint8_t> bytes;  // [ top - bytes.size(), top )
+
+		bool contains( uint64_t address, std::size_t size ) const {
+			return address >= top - limit && address <= top - size;
+		}
+
+		// Accesses of 1 to 8 bytes inside contains(); stores below the allocated part grow it.
+		uint64_t load( uint64_t address, std::size_t size ) const;
+
+		void store( uint64_t address, uint64_t value, std::size_t size );
+	};
+
+	struct guest_memory {
+		static constexpr uint64_t page_size = 4096;
+
+		std::vector<guest_segment> segments;  // sorted by address
+		guest_stack stack;
+
+		std::expected<void,std::string> read( uint64_t address, std::span<uint8_t> out ) const;
+
+		std::expected<void,std::string> write( uint64_t address, std::span<const uint8_t> in );
+
+		// Little-endian loads and stores of 1, 2, 4 or 8 bytes.
+		std::expected<uint64_t,std::string> load( uint64_t address, std::size_t size ) const;
+
+		std::expected<void,std::string> store( uint64_t address, uint64_t value, std::size_t size );
+
+		std::size_t private_pages() const;
+	};
+
 	std::expected<void,std::string> execute_add( const x86_instruction& add_instr, x86_cpu& cpu );
 
 	std::expected<void,std::string> execute_and( const x86_instruction& and_instr, x86_cpu& cpu );
 
-	std::expected<void,std::string> execute_call( const x86_instruction& call_instr, x86_cpu& cpu );
+	std::expected<void,std::string> execute_call( const x86_instruction& call_instr, x86_cpu& cpu, guest_memory& memory );
 
 	std::expected<void,std::string> execute_cmp( const x86_instruction& cmp_instr, x86_cpu& cpu );
 
 	std::expected<void,std::string> execute_cmpb( const x86_instruction& cmpb_instr, x86_cpu& cpu );
 
+	std::expected<void,std::string> execute_cmpb( const x86_instruction& cmpb_instr, x86_cpu& cpu, guest_memory& memory );
+
 	std::expected<void,std::string> execute_cmpq( const x86_instruction& cmpq_instr, x86_cpu& cpu );
 
+	std::expected<void,std::string> execute_cmpq( const x86_instruction& cmpq_instr, x86_cpu& cpu, guest_memory& memory );
+
 	std::expected<void,std::string> execute_endbr64( const x86_instruction& endbr64_instr, x86_cpu& cpu );
 
 	std::expected<void,std::string> execute_hlt( const x86_instruction& hlt_instr, x86_cpu& cpu );
@@ -406,23 +900,33 @@ namespace stig {
 
 	std::expected<void,std::string> execute_jmp( const x86_instruction& jmp_instr, x86_cpu& cpu );
 
+	std::expected<void,std::string> execute_jmp( const x86_instruction& jmp_instr, x86_cpu& cpu, guest_memory& memory );
+
 	std::expected<void,std::string> execute_lea( const x86_instruction& lea_instr, x86_cpu& cpu );
 
 	std::expected<void,std::string> execute_mov( const x86_instruction& mov_instr, x86_cpu& cpu );
 
+	// Also moves between registers and memory; rip-relative operands address from the
+	// end of the instruction.
+	std::expected<void,std::string> execute_mov( const x86_instruction& mov_instr, x86_cpu& cpu, guest_memory& memory );
+
 	std::expected<void,std::string> execute_movb( const x86_instruction& movb_instr, x86_cpu& cpu, std::unordered_map<uint64_t,uint8_t>& ram );
 
+	// Stores the low byte of a register or immediate to guest memory; rip-relative
+	// operands address from the end of the instruction.
+	std::expected<void,std::string> execute_movb( const x86_instruction& movb_instr, x86_cpu& cpu, guest_memory& memory );
+
 	std::expected<void,std::string> execute_nopl( const x86_instruction& nopl_instr, x86_cpu& cpu );
 
 	std::expected<void,std::string> execute_nopw( const x86_instruction& nopw_instr, x86_cpu& cpu );
 
 	std::expected<void,std::string> execute_padding( const x86_instruction& padding_instr, x86_cpu& cpu );
 
-	std::expected<void,std::string> execute_pop( const x86_instruction& pop_instr, x86_cpu& cpu );
+	std::expected<void,std::string> execute_pop( const x86_instruction& pop_instr, x86_cpu& cpu, guest_memory& memory );
 
-	std::expected<void,std::string> execute_push( const x86_instruction& push_instr, x86_cpu& cpu );
+	std::expected<void,std::string> execute_push( const x86_instruction& push_instr, x86_cpu& cpu, guest_memory& memory );
 
-	std::expected<void,std::string> execute_ret( const x86_instruction& ret_instr, x86_cpu& cpu );
+	std::expected<void,std::string> execute_ret( const x86_instruction& ret_instr, x86_cpu& cpu, guest_memory& memory );
 
 	std::expected<void,std::string> execute_sar( const x86_instruction& sar_instr, x86_cpu& cpu );
 
@@ -432,86 +936,529 @@ namespace stig {
 
 	std::expected<void,std::string> execute_xor( const x86_instruction& xor_instr, x86_cpu& cpu );
 
+	struct x86_vm;
+
+	using instruction_handler = std::expected<void,std::string> (*)( x86_vm& vm, const x86_instruction& instruction );
+
+	// Indexed by mnemonic; mnemonics the VM cannot execute get a handler that fails.
+	instruction_handler get_instruction_handler( x86_mnemonic mnemonic );
+
+	// The micro-op an instruction lowers to: its operands resolved to x86_cpu fields,
+	// immediates and memory forms once, at load time. Forms without a micro-op stay
+	// generic and run through the instruction's handler; the others behave exactly as
+	// their handlers would.
+	enum class micro_opcode : uint8_t {
+		generic,
+		nop,
+		mov_rr,
+		mov_ri,
+		mov_rm,   // load
+		mov_mr,   // store
+		add_ri,
+		and_ri,
+		and_rr,
+		cmp_rr,
+		test_rr,
+		xor_rr,
+		lea,
+		jmp,
+		je,
+		jne
+	};
+
+	// One of the registers x86_cpu::get and set handle; dword views zero-extend on write.
+	struct micro_register {
+		int64_t x86_cpu::* field = nullptr;
+		bool dword = false;
+	};
+
+	struct micro_op {
+		micro_opcode opcode = micro_opcode::generic;
+		uint8_t size = 0;       // memory access size in bytes
+		uint8_t scale = 1;
+		micro_register dst;
+		micro_register src;
+		micro_register base;    // memory operands; absent for rip-relative ones
+		micro_register index;
+		int64_t value = 0;      // immediate, displacement, absolute rip-relative address or branch target
+		uint32_t target = 0;    // step at a branch target
+	};
+
+	micro_op lower_micro_op( const x86_instruction& instruction );
+
+	// A program lowered for the interpreter. Steps are in address order and step_at maps
+	// rip - base straight to a step, so only indirect branches look anything up; everything
+	// else follows its precomputed successor. Borrows the program's instructions.
+	struct dispatch_step {
+		const x86_instruction* instruction = nullptr;
+		instruction_handler handler = nullptr;
+		uint64_t fall_through = 0;  // address of the next instruction
+		uint32_t next = 0;          // step at fall_through, or no_step
+		bool branches = false;      // the handler sets rip itself
+		micro_op op{};
+	};
+
+	struct dispatch_table {
+		static constexpr uint32_t no_step = std::numeric_limits<uint32_t>::max();
+		static constexpr uint64_t max_span = uint64_t{ 1 } << 28;
+
+		uint64_t base = 0;
+		std::vector<uint32_t> step_at;
+		std::vector<dispatch_step> steps;
+
+		uint32_t find( uint64_t address ) const {
+			uint64_t offset = address - base;
+			return offset < step_at.size() ? step_at[ offset ] : no_step;
+		}
+	};
+
+	std::expected<dispatch_table,std::string> lower_program( const program& prog );
+
+	// A straight-line run of steps ending at a branch, found the first time execution
+	// reaches its address. exits chain it to the blocks it has left to; for an indirect
+	// branch the second slot is a one-entry inline cache of the last target.
+	struct basic_block {
+		struct exit {
+			uint64_t address = 0;
+			basic_block* block = nullptr;
+		};
+
+		// Host code for the block: runs it, counts the entry in executions, and returns
+		// the next guest rip. A block that branches back to itself loops natively.
+		using compiled_code = uint64_t (*)( x86_cpu* cpu, uint64_t* executions );
+
+		uint32_t first = 0;  // steps [ first, last ] of the dispatch_table
+		uint32_t last = 0;
+		uint64_t executions = 0;
+		std::array<exit,2> exits{};  // fall-through, branch target
+		compiled_code compiled = nullptr;
+		bool uncompilable = false;
+	};
+
+	// Executable memory for compiled blocks, in mmap'd chunks. A chunk is only writable
+	// while code is copied in and is executable only after, never both at once.
+	struct jit_memory {
+		static constexpr std::size_t chunk_size = std::size_t{ 1 } << 16;
+
+		struct chunk {
+			uint8_t* data;
+			std::size_t used;
+		};
+		std::vector<chunk> chunks;
+
+		jit_memory() = default;
+		jit_memory( const jit_memory& ) = delete;
+		jit_memory& operator=( const jit_memory& ) = delete;
+		jit_memory( jit_memory&& other ) noexcept;
+		jit_memory& operator=( jit_memory&& other ) noexcept;
+		~jit_memory();
+
+		// Copies code into executable memory; nullptr when it cannot be mapped.
+		const uint8_t* add( std::span<const uint8_t> code );
+	};
+
+	// Translates a block to host x86-64 code. Only blocks made entirely of register
+	// micro-ops compile; anything touching guest memory, the stack or a handler does not.
+	std::optional<std::vector<uint8_t>> compile_block( const dispatch_table& table, const basic_block& block );
+
+	struct block_cache {
+		const dispatch_table* table = nullptr;
+		uint64_t exit_point = 0;
+		std::unordered_map<uint64_t,basic_block> blocks{};  // by entry address; nodes never move
+
+		// Blocks entered jit_threshold times are compiled; 0 keeps everything interpreted.
+		// verify_jit also interprets every compiled run from the same state and fails on
+		// the first difference, for differential testing.
+		uint64_t jit_threshold = 0;
+		bool verify_jit = false;
+		jit_memory jit{};
+
+		// The block starting at address, discovering it on first use; nullptr when no
+		// instruction starts there.
+		basic_block* find( uint64_t address );
+	};
+
 	struct x86_vm {
 		x86_cpu cpu;
-		std::unordered_map<uint64_t,uint8_t> ram;
-
-		std::expected<void,std::string> execute_instruction( x86_instruction& instruction ) {
-			switch ( instruction.mnemonic ) {
-		/*0*/	case x86_mnemonic::add:
-					return execute_add( instruction, cpu );
-		/*1*/	case x86_mnemonic::and_:
-					return execute_and( instruction, cpu );
-		/*2*/	case x86_mnemonic::call:
-					return execute_call( instruction, cpu );
-		/*3*/	case x86_mnemonic::cmp:
-					return execute_cmp( instruction, cpu );
-		/*4*/	case x86_mnemonic::cmpb:
-					return execute_cmpb( instruction, cpu );
-		/*5*/	case x86_mnemonic::cmpq:
-					return execute_cmpq( instruction, cpu );
-		/*6*/	case x86_mnemonic::endbr64:
-					return execute_endbr64( instruction, cpu );
-		/*7*/	case x86_mnemonic::hlt:
-					return execute_hlt( instruction, cpu );
-		/*8*/	case x86_mnemonic::je:
-					return execute_je( instruction, cpu );
-		/*9*/	case x86_mnemonic::jmp:
-					return execute_jmp( instruction, cpu );
-		/*10*/	case x86_mnemonic::jne:
-					return execute_jne( instruction, cpu );
-		/*11*/	case x86_mnemonic::lea:
-					return execute_lea( instruction, cpu );
-		/*12*/	case x86_mnemonic::mov:
-					return execute_mov( instruction, cpu );
-		/*13*/	case x86_mnemonic::movb:
-					return execute_movb( instruction, cpu, ram );
-		/*14*/	case x86_mnemonic::nopl:
-					return execute_nopl( instruction, cpu );
-		/*15*/	case x86_mnemonic::nopw:
-					return execute_nopw( instruction, cpu );
-		/*16*/	case x86_mnemonic::padding:
-					return execute_padding( instruction, cpu );
-		/*17*/	case x86_mnemonic::pop:
-					return execute_pop( instruction, cpu );
-		/*18*/	case x86_mnemonic::push:
-					return execute_push( instruction, cpu );
-		/*19*/	case x86_mnemonic::ret:
-					return execute_ret( instruction, cpu );
-		/*20*/	case x86_mnemonic::sar:
-					return execute_sar( instruction, cpu );
-		/*21*/	case x86_mnemonic::shr:
-					return execute_shr( instruction, cpu );
-		/*22*/	case x86_mnemonic::test:
-					return execute_test( instruction, cpu );
-		/*23*/	case x86_mnemonic::xor_:
-					return execute_xor( instruction, cpu );
-				default:
-					return std::unexpected( "Unimplemented instruction" );
-			}
+		guest_memory memory;
+
+		// Starts with rsp at the top of an empty guest stack.
+		x86_vm() {
+			cpu.rsp = static_cast<int64_t>( guest_stack::top );
 		}
 
-		uint32_t load_program( program& prog ) {
-			cpu.rip = prog.entry_point;
-			while ( cpu.rip != prog.exit_point ) {
-				execute_instruction( prog.instrs[ cpu.rip ] );
-			}
-			return cpu.rax;
+		std::expected<void,std::string> execute_instruction( const x86_instruction& instruction ) {
+			return get_instruction_handler( instruction.mnemonic )( *this, instruction );
 		}
 
+		// Executes one step and leaves rip at the next instruction to run.
+		std::expected<void,std::string> execute_step( const dispatch_step& step );
+
+		// Runs from entry_point until rip reaches exit_point and returns eax. The first
+		// failing instruction, or a jump to an address with no instruction, stops it.
+		std::expected<uint32_t,std::string> run( const dispatch_table& table, uint64_t entry_point, uint64_t exit_point );
+
+		// The same, a block at a time, following the blocks' chained successors.
+		std::expected<uint32_t,std::string> run( block_cache& cache, uint64_t entry_point );
+
+		std::expected<uint32_t,std::string> load_program( const program& prog );
+
 	}; // x86_vm
 
+	enum class map_advice : uint8_t {
+		normal,
+		random,
+		sequential
+	};
+
+	struct mapped_file {
+		const char* data = nullptr;
+		std::size_t size = 0;
+
+		mapped_file() = default;
+		mapped_file( const mapped_file& ) = delete;
+		mapped_file& operator=( const mapped_file& ) = delete;
+		mapped_file( mapped_file&& other ) noexcept;
+		mapped_file& operator=( mapped_file&& other ) noexcept;
+		~mapped_file();
+
+		std::string_view text() const {
+			return { data, size };
+		}
+
+		std::span<const uint8_t> bytes() const {
+			return { reinterpret_cast<const uint8_t*>( data ), size };
+		}
+	};
+
+	std::expected<mapped_file,std::string> map_file( const std::string& file_name, map_advice advice = map_advice::sequential );
+
+	// An ELF64 image mapped once. Header, section and program header tables and every
+	// section's contents are validated against the image when it is opened, so the
+	// accessors hand out spans into the mapping with no syscalls, copies or checks.
+	struct elf_file {
+		mapped_file file;                 // empty when the image is borrowed
+		std::span<const uint8_t> image;
+		const elf64_ehdr* header = nullptr;
+		std::span<const elf64_shdr> sections;
+		std::span<const elf64_phdr> segments;
+
+		// Empty for SHT_NOBITS sections such as .bss.
+		std::span<const uint8_t> contents( const elf64_shdr& section ) const;
+
+		// The NUL-terminated string at offset in a string table section; empty when out of range.
+		std::string_view string( const elf64_shdr& table, uint64_t offset ) const;
+
+		std::string_view section_name( const elf64_shdr& section ) const {
+			return string( sections[ header->e_shstrndx ], section.sh_name );
+		}
+
+		const elf64_shdr* find_section( std::string_view name ) const;
+
+		// Symbol and relocation tables, sized by whole entries.
+		std::span<const elf64_sym> symbols( const elf64_shdr& table ) const;
+		std::span<const elf64_rela> relocations( const elf64_shdr& table ) const;
+	};
+
+	std::expected<elf_file,std::string> open_elf_file( const std::string& file_name );
+
+	// Borrows image, which must outlive the returned elf_file.
+	std::expected<elf_file,std::string> open_elf_image( std::span<const uint8_t> image );
+
+	// Maps each PT_LOAD segment of elf at its p_vaddr. elf must outlive the result, which
+	// reads the segments in place.
+	std::expected<guest_memory,std::string> load_segments( const elf_file& elf );
+
+	struct symbol_entry {
+		uint64_t address;
+		uint64_t end;
+		std::string_view name;
+	};
+
+	// Defined functions from .symtab and .dynsym plus objdump's foo@plt stubs, one name per
+	// address, preferring global ones. Lookups binary search the address and name columns,
+	// and the index owns its names so it outlives the elf_file.
+	struct symbol_index {
+		std::vector<uint64_t> starts;
+		std::vector<uint64_t> ends;
+		std::vector<uint32_t> name_offsets;  // symbol i's name is names[ name_offsets[ i ], name_offsets[ i + 1 ] )
+		std::string names;
+		std::vector<uint32_t> by_name;       // symbol numbers sorted by name
+
+		std::size_t size() const {
+			return starts.size();
+		}
+
+		symbol_entry operator[]( std::size_t i ) const;
+
+		std::optional<symbol_entry> find( std::string_view name ) const;
+
+		// The function whose [address, end) range covers address.
+		std::optional<symbol_entry> containing( uint64_t address ) const;
+	};
+
+	symbol_index build_symbol_index( const elf_file& elf );
+
+	std::string_view next_line_view( std::string_view text, std::size_t& pos );
+
+	// Yields the same lines as repeated next_line_view calls, but finds newlines
+	// 64 bytes at a time and hands them out from a bit mask.
+	struct line_scanner {
+		std::string_view text;
+		std::size_t pos = 0;
+		std::size_t block = 0;
+		uint64_t newlines = 0;
+
+		explicit line_scanner( std::string_view text ) : text( text ) {}
+
+		bool has_next() const {
+			return pos < text.size();
+		}
+
+		std::string_view next();
+	};
+
+	std::optional<std::string_view> get_function_view( std::string_view text, std::string_view function_name );
+
+	struct function_chunk {
+		elf_section section;
+		std::string_view body;
+	};
+
+	std::vector<function_chunk> split_functions( std::string_view text );
+
+	std::expected<elf64_x86_64,std::string> parse_disassembly_text( std::string_view text, std::pmr::memory_resource* resource = std::pmr::get_default_resource() );
+
+	// With more than one thread the resource is used from every worker, so it must be
+	// thread-safe (e.g. std::pmr::synchronized_pool_resource, or the default resource).
+	std::expected<elf64_x86_64,std::string> parse_disassembly( const mapped_file& file, std::size_t thread_count = 0,
+															   std::pmr::memory_resource* resource = std::pmr::get_default_resource() );
+
+	std::expected<elf64_x86_64,std::string> parse_disassembly( const std::string& file_name, std::size_t thread_count = 0,
+															   std::pmr::memory_resource* resource = std::pmr::get_default_resource() );
+
+	std::expected<instruction_store,std::string> parse_instruction_store( const mapped_file& file );
+
+	std::expected<instruction_store,std::string> parse_instruction_store( const std::string& file_name );
+
+	// ===================
+	//  Disassembly Cache
+	// ===================
+
+	// On-disk image of a parsed elf64_x86_64: a header followed by flat arrays of
+	// fixed-size records and two blobs (machine bytes, function names). Every array
+	// starts on an 8 byte boundary so a mapped cache can be read in place. The format
+	// uses host byte order; it is a local cache, not an interchange format.
+
+	inline constexpr std::array<char,8> cache_magic = { 'S', 'T', 'I', 'G', 'D', 'I', 'S', 'C' };
+	inline constexpr uint32_t cache_version = 1;
+
+	struct cache_section {
+		uint64_t begin;
+		uint64_t end;
+		uint32_t function_begin;
+		uint32_t function_count;
+	};
+
+	struct cache_function {
+		uint32_t name_offset;
+		uint32_t name_length;
+		uint32_t instruction_begin;
+		uint32_t instruction_count;
+	};
+
+	struct cache_instruction {
+		uint64_t address;
+		uint32_t byte_offset;
+		uint32_t operand_begin;
+		uint8_t byte_count;
+		x86_mnemonic mnemonic;
+		uint8_t operand_count;   // no_operands when std::nullopt
+		uint8_t reserved[ 5 ];
+
+		static constexpr uint8_t no_operands = 0xff;
+	};
+
+	enum class cache_operand_kind : uint8_t {
+		reg,
+		immediate,
+		memory,
+		address
+	};
+
+	struct cache_operand {
+		int64_t value;   // immediate, address or displacement
+		cache_operand_kind kind;
+		x86_register reg;   // register operand or memory base
+		x86_register index;
+		uint8_t scale;
+		uint8_t flags;
+		uint8_t reserved[ 3 ];
+
+		static constexpr uint8_t has_base = 1 << 0;
+		static constexpr uint8_t has_index = 1 << 1;
+		static constexpr uint8_t has_scale = 1 << 2;
+		static constexpr uint8_t has_displacement = 1 << 3;
+	};
+
+	struct cache_header {
+		std::array<char,8> magic;
+		uint32_t version;
+		uint32_t reserved;
+		uint64_t source_hash;
+		uint64_t source_size;
+		uint64_t function_count;
+		uint64_t instruction_count;
+		uint64_t operand_count;
+		uint64_t byte_count;
+		uint64_t name_bytes;
+		std::array<cache_section,5> sections;
+	};
+
+	static_assert( sizeof( cache_header ) % 8 == 0 && sizeof( cache_instruction ) % 8 == 0 && sizeof( cache_operand ) % 8 == 0 );
+
+	// Read-only view of a mapped cache file. The spans point straight into the mapping.
+	struct disassembly_cache {
+		mapped_file file;
+		const cache_header* header = nullptr;
+		std::span<const cache_function> functions;
+		std::span<const cache_instruction> instructions;
+		std::span<const cache_operand> operands;
+		std::span<const uint8_t> bytes;
+		std::string_view names;
+
+		std::string_view name( const cache_function& func ) const {
+			return names.substr( func.name_offset, func.name_length );
+		}
+
+		std::span<const cache_function> section_functions( const elf_section section ) const {
+			if ( section == elf_section::unknown ) {
+				return {};
+			}
+			const auto& s = header->sections[ static_cast<std::size_t>( section ) ];
+			return functions.subspan( s.function_begin, s.function_count );
+		}
+
+		x86_instruction instruction( const cache_instruction& instr, std::pmr::memory_resource* resource = std::pmr::get_default_resource() ) const;
+
+		function to_function( const cache_function& func, std::pmr::memory_resource* resource = std::pmr::get_default_resource() ) const;
+
+		elf64_x86_64 to_elf( std::pmr::memory_resource* resource = std::pmr::get_default_resource() ) const;
+	};
+
+	uint64_t hash_bytes( std::span<const uint8_t> bytes );
+
+	std::expected<void,std::string> write_disassembly_cache( const std::string& file_name, const elf64_x86_64& elf, uint64_t source_hash, uint64_t source_size );
+
+	std::expected<disassembly_cache,std::string> open_disassembly_cache( const std::string& file_name );
+
+	// Returns the cached parse of source_file when cache_file matches its contents,
+	// otherwise parses source_file and rewrites cache_file.
+	std::expected<elf64_x86_64,std::string> parse_disassembly_cached( const std::string& source_file, const std::string& cache_file, std::size_t thread_count = 0 );
+
+	std::optional<std::string_view> match_function_header( std::string_view line );
+
 	int get_empty_line_offset( std::ifstream& file, std::size_t start_line );
 
 	std::optional<std::size_t> get_function_name_line_no( std::ifstream& file, const std::string& function_name );
 
+	struct function_location {
+		std::size_t offset;
+		std::size_t length;
+	};
+
+	using function_index = std::unordered_map<std::string,function_location>;
+
 	std::expected<std::string,std::string> get_function_str( std::ifstream& file, const std::string& function_name );
 
+	std::expected<std::string,std::string> get_function_str( std::ifstream& file, const function_location& location );
+
+	std::expected<function_index,std::string> build_function_index( std::ifstream& file );
+
+	std::expected<function_index,std::string> build_function_index( const mapped_file& file );
+
+	std::expected<function_index,std::string> build_function_index( const std::string& file_name );
+
 	std::expected<function,std::string> extract_function( const std::string& file_name, const std::string& function_name );
 
+	std::expected<function,std::string> extract_function( std::ifstream& file, const function_index& index, const std::string& function_name );
+
+	std::expected<function,std::string> extract_function( const mapped_file& file, const function_index& index, const std::string& function_name );
+
+	std::expected<std::vector<function>,std::string> extract_functions( const std::string& file_name, const std::vector<std::string>& function_names );
+
 	std::expected<std::vector<std::string>,std::string> extract_function_names( const std::string& file_name );
 
-	std::expected<x86_instruction,std::string> parse_x86_instruction( std::span<const uint8_t> bytes );
+	std::expected<std::vector<std::string_view>,std::string> extract_function_names( const mapped_file& file );
+
+	// Decodes the instruction at the start of bytes, which sits at address. Operands follow
+	// objdump's AT&T order and spelling, so the result matches parse_compact_instruction
+	// on objdump's line for the same bytes.
+	std::expected<x86_compact_instruction,std::string> decode_compact_instruction( std::span<const uint8_t> bytes, uint64_t address );
+
+	enum class decode_error : uint8_t {
+		none,
+		truncated,
+		unsupported_opcode,
+		expected_memory,
+		unsupported_operand_size
+	};
+
+	constexpr std::string_view decode_error_message( decode_error error ) {
+		switch ( error ) {
+			case decode_error::none:
+				return "No Error";
+			case decode_error::truncated:
+				return "Truncated Instruction";
+			case decode_error::unsupported_opcode:
+				return "Unsupported Opcode";
+			case decode_error::expected_memory:
+				return "Expected Memory Operand";
+			case decode_error::unsupported_operand_size:
+				return "Unsupported Operand Size";
+		}
+		return "Unknown Decode Error";
+	}
+
+	struct decode_batch_result {
+		std::size_t count = 0;                  // instructions written to out
+		std::size_t consumed = 0;               // bytes they cover; where decoding stopped
+		decode_error error = decode_error::none;
+	};
+
+	// Decodes back to back instructions from bytes into out until either runs out or an
+	// instruction fails to decode, in which case error says why and consumed is its
+	// offset. Nothing is allocated, so a scanner can reuse one buffer across calls.
+	decode_batch_result decode_instructions( std::span<const uint8_t> bytes, uint64_t address, std::span<x86_compact_instruction> out );
+
+	std::expected<x86_instruction,std::string> parse_x86_instruction( std::span<const uint8_t> bytes, uint64_t address = 0,
+																	  std::pmr::memory_resource* resource = std::pmr::get_default_resource() );
+
+	enum class disassembly_mode : uint8_t {
+		linear_sweep,       // every byte of every function, as objdump -d decodes them
+		recursive_descent   // only code reachable from e_entry and the function symbols
+	};
+
+	// Builds the same elf64_x86_64 as parse_disassembly, straight from an ELF image and
+	// without objdump. .init, .plt, .plt.got, .text and .fini are found by name, split
+	// at .symtab function symbols (PLT stubs are named foo@plt from their GOT
+	// relocations, as objdump does) and decoded. Instructions come out whole, so there
+	// are no padding continuation entries.
+	//
+	// recursive_descent follows call, jmp, je and jne targets instead of sweeping, so
+	// alignment padding and data islands are never decoded; functions nothing reaches
+	// are left out.
+	std::expected<elf64_x86_64,std::string> parse_elf( const elf_file& elf,
+													   disassembly_mode mode = disassembly_mode::linear_sweep,
+													   std::pmr::memory_resource* resource = std::pmr::get_default_resource() );
+
+	std::expected<elf64_x86_64,std::string> parse_elf( std::span<const uint8_t> image,
+													   disassembly_mode mode = disassembly_mode::linear_sweep,
+													   std::pmr::memory_resource* resource = std::pmr::get_default_resource() );
+
+	std::expected<elf64_x86_64,std::string> parse_elf( const std::string& file_name,
+													   disassembly_mode mode = disassembly_mode::linear_sweep,
+													   std::pmr::memory_resource* resource = std::pmr::get_default_resource() );
 
 } // namespace stig
 
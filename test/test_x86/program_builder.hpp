@@ -0,0 +1,19 @@
+#pragma once
+
+#include <x86.hpp>
+
+// Builds a function instruction by instruction, each placed where the previous one
+// ended; the machine bytes are nop filler of the given size.
+struct program_builder {
+	stig::function func;
+	uint64_t address = 0;
+
+	void add( std::size_t size, stig::x86_mnemonic mnemonic, std::vector<stig::x86_operand> operands ) {
+		func.instructions.push_back( { address, std::vector<uint8_t>( size, 0x90 ), mnemonic, std::move( operands ) } );
+		address += size;
+	}
+};
+
+inline stig::x86_memory at( stig::x86_register base, int64_t displacement ) {
+	return { base, std::nullopt, std::nullopt, displacement };
+}
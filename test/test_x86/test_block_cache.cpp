@@ -0,0 +1,60 @@
+#include <gtest/gtest.h>
+
+#include <x86.hpp>
+
+#include "program_builder.hpp"
+
+TEST( UnitTest, BlockCache ) {
+	using stig::x86_mnemonic;
+	using stig::x86_register;
+	// Calls a function at 0x30 through %rax three times.
+	program_builder b;
+	b.add( 7, x86_mnemonic::mov, { stig::x86_immediate{ 3 }, x86_register::rdx } );
+	uint64_t loop = b.address;
+	b.add( 7, x86_mnemonic::mov, { stig::x86_immediate{ 0x30 }, x86_register::rax } );
+	b.add( 2, x86_mnemonic::call, { x86_register::rax } );
+	uint64_t after_call = b.address;
+	b.add( 4, x86_mnemonic::add, { stig::x86_immediate{ -1 }, x86_register::rdx } );
+	b.add( 3, x86_mnemonic::test, { x86_register::rdx, x86_register::rdx } );
+	b.add( 2, x86_mnemonic::jne, { stig::x86_address{ loop } } );
+	b.add( 2, x86_mnemonic::jmp, { stig::x86_address{ 0x40 } } );
+	b.address = 0x30;
+	b.add( 4, x86_mnemonic::add, { stig::x86_immediate{ 1 }, x86_register::rsi } );
+	b.add( 1, x86_mnemonic::ret, {} );
+
+	auto prog = stig::convert_to_program( b.func );
+	ASSERT_TRUE( prog ) << prog.error();
+	auto table = stig::lower_program( prog.value() );
+	ASSERT_TRUE( table ) << table.error();
+	stig::block_cache cache{ &table.value(), 0x40 };
+	stig::x86_vm vm{};
+	auto result = vm.run( cache, 0 );
+	ASSERT_TRUE( result ) << result.error();
+	EXPECT_EQ( vm.cpu.rsi, 3 );
+	EXPECT_EQ( vm.cpu.rip, 0x40 );
+
+	// Entry, loop head, loop tail, the exit jump and the callee.
+	EXPECT_EQ( cache.blocks.size(), 5 );
+	EXPECT_EQ( cache.blocks.at( 0 ).executions, 1 );
+	EXPECT_EQ( cache.blocks.at( loop ).executions, 2 );
+	EXPECT_EQ( cache.blocks.at( after_call ).executions, 3 );
+	EXPECT_EQ( cache.blocks.at( 0x30 ).executions, 3 );
+
+	// Blocks end at their branch and are chained to where they went.
+	const auto& head = cache.blocks.at( loop );
+	EXPECT_EQ( table->steps[ head.last ].instruction->mnemonic, x86_mnemonic::call );
+	EXPECT_EQ( head.exits[ 1 ].address, 0x30 );
+	EXPECT_EQ( head.exits[ 1 ].block, &cache.blocks.at( 0x30 ) );
+	const auto& callee = cache.blocks.at( 0x30 );
+	EXPECT_EQ( callee.exits[ 1 ].address, after_call );
+	const auto& tail = cache.blocks.at( after_call );
+	EXPECT_EQ( tail.exits[ 1 ].block, &head );
+
+	// Stepping one instruction at a time ends in the same state.
+	stig::x86_vm stepped{};
+	auto stepped_result = stepped.run( table.value(), 0, 0x40 );
+	ASSERT_TRUE( stepped_result ) << stepped_result.error();
+	EXPECT_EQ( stepped.cpu.rsi, vm.cpu.rsi );
+	EXPECT_EQ( stepped.cpu.rdx, vm.cpu.rdx );
+	EXPECT_EQ( stepped.cpu.rax, vm.cpu.rax );
+}
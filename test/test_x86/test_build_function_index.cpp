@@ -0,0 +1,27 @@
+#include <gtest/gtest.h>
+
+#include <x86.hpp>
+
+#include "test_constants.hpp"
+
+TEST( UnitTest, BuildFunctionIndex ) {
+	auto index_result = stig::build_function_index( "../test/main_disasm.txt" );
+	ASSERT_TRUE( index_result ) << index_result.error();
+	auto& index = index_result.value();
+	EXPECT_EQ( index.size(), 11 );
+	ASSERT_TRUE( index.contains( "main" ) );
+	ASSERT_TRUE( index.contains( "_fini" ) );
+	std::ifstream file( "../test/main_disasm.txt", std::ios::binary );
+	auto res = stig::extract_function( file, index, "main" );
+	ASSERT_TRUE( res ) << res.error();
+	EXPECT_EQ( res.value(), test::expected_main );
+}
+
+TEST( UnitTest, BuildFunctionIndex_LastFunction ) {
+	std::ifstream file( "../test/main_disasm.txt", std::ios::binary );
+	auto index_result = stig::build_function_index( file );
+	ASSERT_TRUE( index_result ) << index_result.error();
+	auto res = stig::extract_function( file, index_result.value(), "_fini" );
+	ASSERT_TRUE( res ) << res.error();
+	EXPECT_EQ( res.value().instructions.size(), 4 );
+}
@@ -0,0 +1,69 @@
+#include <gtest/gtest.h>
+
+#include <x86.hpp>
+
+#include "test_constants.hpp"
+
+static_assert( sizeof( stig::x86_compact_instruction ) == 64 );
+static_assert( alignof( stig::x86_compact_instruction ) == 64 );
+static_assert( std::is_trivially_copyable_v<stig::x86_compact_instruction> );
+
+TEST( UnitTest, CompactInstruction ) {
+	stig::x86_memory mem{ stig::x86_register::rbp, stig::x86_register::rax, 8, -0x18 };
+	stig::x86_instruction instruction = {
+		0x1131,
+		std::vector<uint8_t>{ 0x48, 0x89, 0x44, 0xc5, 0xe8 },
+		stig::x86_mnemonic::mov,
+		std::vector<stig::x86_operand>{ stig::x86_register::rax, mem }
+	};
+	auto compact = stig::convert_to_compact( instruction );
+	ASSERT_TRUE( compact ) << compact.error();
+	EXPECT_EQ( compact->bytes().size(), 5 );
+	EXPECT_EQ( compact->operands_size(), 2 );
+	EXPECT_EQ( compact->kind( 0 ), stig::x86_operand_kind::reg );
+	EXPECT_EQ( compact->kind( 1 ), stig::x86_operand_kind::memory );
+	EXPECT_EQ( compact->operand( 1 ), stig::x86_operand{ mem } );
+	EXPECT_EQ( stig::convert_to_instruction( compact.value() ), instruction );
+
+	stig::x86_instruction no_operands = { 0x1141, { 0xc3 }, stig::x86_mnemonic::ret, std::nullopt };
+	auto compact_ret = stig::convert_to_compact( no_operands );
+	ASSERT_TRUE( compact_ret ) << compact_ret.error();
+	EXPECT_FALSE( compact_ret->has_operands() );
+	EXPECT_EQ( stig::convert_to_instruction( compact_ret.value() ), no_operands );
+}
+
+TEST( UnitTest, CompactInstruction_TooManyOperands ) {
+	stig::x86_instruction instruction = {
+		0x1000,
+		std::vector<uint8_t>{ 0x90 },
+		stig::x86_mnemonic::mov,
+		std::vector<stig::x86_operand>( 4, stig::x86_register::rax )
+	};
+	EXPECT_FALSE( stig::convert_to_compact( instruction ) );
+}
+
+TEST( UnitTest, ParseCompactFunction ) {
+	auto elf = stig::parse_disassembly( "../test/main_disasm.txt", 1 );
+	ASSERT_TRUE( elf ) << elf.error();
+	for ( const auto& func : elf->text ) {
+		auto compact = stig::convert_to_compact( func );
+		ASSERT_TRUE( compact ) << compact.error();
+		EXPECT_EQ( stig::convert_to_function( compact.value() ), func );
+	}
+	auto file = stig::map_file( "../test/main_disasm.txt" );
+	ASSERT_TRUE( file ) << file.error();
+	auto body = stig::get_function_view( file->text(), "main" );
+	ASSERT_TRUE( body );
+	auto compact_main = stig::parse_compact_function( body.value() );
+	ASSERT_TRUE( compact_main ) << compact_main.error();
+	EXPECT_EQ( compact_main->name, "main" );
+	EXPECT_EQ( stig::convert_to_function( compact_main.value() ), test::expected_main );
+}
+
+TEST( UnitTest, ParseCompactInstruction_InvalidOperands ) {
+	auto parsed = stig::parse_compact_instruction( "    1149:\t48 89 e5             \tmov    %rsp,%rbp" );
+	ASSERT_TRUE( parsed ) << parsed.error();
+	EXPECT_EQ( parsed->operands_size(), 2 );
+	EXPECT_FALSE( stig::parse_compact_instruction( "    1149:\t48 89 e5             \tmov    %rsp,%bogus" ) );
+	EXPECT_FALSE( stig::parse_compact_instruction( "    1149:\t48 89 e5             \tmov    %rsp,%rbp,%rax,%rdx" ) );
+}
@@ -0,0 +1,52 @@
+#include <gtest/gtest.h>
+
+#include <x86.hpp>
+
+TEST( UnitTest, DecodeInstructions ) {
+	auto elf = stig::parse_elf( "../test/main" );
+	ASSERT_TRUE( elf ) << elf.error();
+	std::vector<uint8_t> bytes;
+	std::vector<stig::x86_instruction> expected;
+	for ( const auto& func : elf->text ) {
+		for ( const auto& instruction : func.instructions ) {
+			bytes.insert( bytes.end(), instruction.machine_bytes.begin(), instruction.machine_bytes.end() );
+			expected.push_back( instruction );
+		}
+	}
+	ASSERT_FALSE( expected.empty() );
+
+	std::vector<stig::x86_compact_instruction> out( expected.size() + 8 );
+	auto result = stig::decode_instructions( bytes, expected.front().address, out );
+	EXPECT_EQ( result.error, stig::decode_error::none );
+	EXPECT_EQ( result.consumed, bytes.size() );
+	ASSERT_EQ( result.count, expected.size() );
+	for ( std::size_t i = 0; i < result.count; ++i ) {
+		EXPECT_EQ( stig::convert_to_instruction( out[ i ] ), expected[ i ] );
+	}
+
+	// A full buffer stops the batch cleanly; the next call picks up at consumed.
+	auto first = stig::decode_instructions( bytes, expected.front().address, std::span( out ).first( 2 ) );
+	EXPECT_EQ( first.count, 2 );
+	EXPECT_EQ( first.error, stig::decode_error::none );
+	EXPECT_EQ( first.consumed, expected[ 0 ].machine_bytes.size() + expected[ 1 ].machine_bytes.size() );
+	auto rest = stig::decode_instructions( std::span( bytes ).subspan( first.consumed ), expected[ 2 ].address, out );
+	EXPECT_EQ( first.count + rest.count, expected.size() );
+}
+
+TEST( UnitTest, DecodeInstructions_Errors ) {
+	std::array<stig::x86_compact_instruction,4> out;
+	auto unsupported = stig::decode_instructions( std::vector<uint8_t>{ 0x90, 0x0f, 0x0b }, 0x1000, out );
+	EXPECT_EQ( unsupported.count, 1 );
+	EXPECT_EQ( unsupported.consumed, 1 );
+	EXPECT_EQ( unsupported.error, stig::decode_error::unsupported_opcode );
+	EXPECT_EQ( stig::decode_error_message( unsupported.error ), "Unsupported Opcode" );
+
+	auto truncated = stig::decode_instructions( std::vector<uint8_t>{ 0xc3, 0xe8, 0x00 }, 0x1000, out );
+	EXPECT_EQ( truncated.count, 1 );
+	EXPECT_EQ( truncated.consumed, 1 );
+	EXPECT_EQ( truncated.error, stig::decode_error::truncated );
+
+	auto empty = stig::decode_instructions( {}, 0x1000, out );
+	EXPECT_EQ( empty.count, 0 );
+	EXPECT_EQ( empty.error, stig::decode_error::none );
+}
@@ -0,0 +1,86 @@
+#include <gtest/gtest.h>
+
+#include <x86.hpp>
+
+// objdump splits long instructions over several lines; fold the byte-only continuation
+// lines back into the instruction they belong to.
+static std::vector<stig::x86_instruction> fold_padding( const stig::function& func ) {
+	std::vector<stig::x86_instruction> folded;
+	for ( const auto& instruction : func.instructions ) {
+		if ( instruction.mnemonic == stig::x86_mnemonic::padding && !folded.empty() ) {
+			auto& bytes = folded.back().machine_bytes;
+			bytes.insert( bytes.end(), instruction.machine_bytes.begin(), instruction.machine_bytes.end() );
+			continue;
+		}
+		folded.push_back( instruction );
+	}
+	return folded;
+}
+
+TEST( UnitTest, DecodeX86Instruction_MatchesText ) {
+	auto elf = stig::parse_disassembly( "../test/main_disasm.txt", 1 );
+	ASSERT_TRUE( elf ) << elf.error();
+	std::size_t decoded = 0;
+	for ( auto section : { stig::elf_section::init, stig::elf_section::plt, stig::elf_section::plt_got,
+						   stig::elf_section::text, stig::elf_section::fini } ) {
+		for ( const auto& func : *elf->functions( section ) ) {
+			auto expected = fold_padding( func );
+			std::vector<uint8_t> bytes;
+			for ( const auto& instruction : expected ) {
+				bytes.insert( bytes.end(), instruction.machine_bytes.begin(), instruction.machine_bytes.end() );
+			}
+			std::size_t offset = 0;
+			for ( const auto& instruction : expected ) {
+				auto result = stig::parse_x86_instruction( std::span( bytes ).subspan( offset ), instruction.address );
+				ASSERT_TRUE( result ) << func.name << " +" << offset << ": " << result.error();
+				EXPECT_EQ( result.value(), instruction ) << func.name << " at 0x" << std::hex << instruction.address;
+				offset += result->machine_bytes.size();
+				++decoded;
+			}
+			EXPECT_EQ( offset, bytes.size() );
+		}
+	}
+	EXPECT_GT( decoded, 80 );
+}
+
+TEST( UnitTest, DecodeX86Instruction_Forms ) {
+	auto wrapped = stig::decode_compact_instruction( std::vector<uint8_t>{ 0x48, 0x83, 0xe4, 0xf0 }, 0x1044 );
+	ASSERT_TRUE( wrapped ) << wrapped.error();
+	EXPECT_EQ( wrapped->mnemonic, stig::x86_mnemonic::and_ );
+	EXPECT_EQ( wrapped->operand( 0 ), stig::x86_operand{ stig::x86_immediate{ -16 } } );
+	EXPECT_EQ( wrapped->operand( 1 ), stig::x86_operand{ stig::x86_register::rsp } );
+
+	auto high_byte = stig::decode_compact_instruction( std::vector<uint8_t>{ 0x88, 0xe0 }, 0 );
+	ASSERT_TRUE( high_byte ) << high_byte.error();
+	EXPECT_EQ( high_byte->operand( 0 ), stig::x86_operand{ stig::x86_register::ah } );
+	auto rex_byte = stig::decode_compact_instruction( std::vector<uint8_t>{ 0x40, 0x88, 0xe0 }, 0 );
+	ASSERT_TRUE( rex_byte ) << rex_byte.error();
+	EXPECT_EQ( rex_byte->operand( 0 ), stig::x86_operand{ stig::x86_register::spl } );
+
+	auto jump = stig::decode_compact_instruction( std::vector<uint8_t>{ 0x0f, 0x85, 0x10, 0x00, 0x00, 0x00 }, 0x2000 );
+	ASSERT_TRUE( jump ) << jump.error();
+	EXPECT_EQ( jump->mnemonic, stig::x86_mnemonic::jne );
+	EXPECT_EQ( jump->operand( 0 ), stig::x86_operand{ stig::x86_address{ 0x2016 } } );
+}
+
+TEST( UnitTest, DecodeX86Instruction_SuffixedMnemonics ) {
+	auto cmpb = stig::decode_compact_instruction( std::vector<uint8_t>{ 0x80, 0x38, 0x05 }, 0 );
+	ASSERT_TRUE( cmpb ) << cmpb.error();
+	EXPECT_EQ( cmpb->mnemonic, stig::x86_mnemonic::cmpb );
+	auto cmp = stig::decode_compact_instruction( std::vector<uint8_t>{ 0x80, 0xf8, 0x05 }, 0 );
+	ASSERT_TRUE( cmp ) << cmp.error();
+	EXPECT_EQ( cmp->mnemonic, stig::x86_mnemonic::cmp );
+	auto nopw = stig::decode_compact_instruction( std::vector<uint8_t>{ 0x66, 0x0f, 0x1f, 0x44, 0x00, 0x00 }, 0 );
+	ASSERT_TRUE( nopw ) << nopw.error();
+	EXPECT_EQ( nopw->mnemonic, stig::x86_mnemonic::nopw );
+	// movl has no x86_mnemonic to name it.
+	EXPECT_FALSE( stig::decode_compact_instruction( std::vector<uint8_t>{ 0xc7, 0x00, 0x01, 0x00, 0x00, 0x00 }, 0 ) );
+}
+
+TEST( UnitTest, DecodeX86Instruction_Errors ) {
+	EXPECT_FALSE( stig::decode_compact_instruction( std::vector<uint8_t>{}, 0 ) );
+	EXPECT_FALSE( stig::decode_compact_instruction( std::vector<uint8_t>{ 0x48, 0x83 }, 0 ) );
+	EXPECT_FALSE( stig::decode_compact_instruction( std::vector<uint8_t>{ 0xe8, 0x00, 0x00 }, 0 ) );
+	EXPECT_FALSE( stig::decode_compact_instruction( std::vector<uint8_t>{ 0x0f, 0x0b }, 0 ) );
+	EXPECT_FALSE( stig::decode_compact_instruction( std::vector<uint8_t>{ 0x8d, 0xc0 }, 0 ) );
+}
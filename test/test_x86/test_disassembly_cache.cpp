@@ -0,0 +1,68 @@
+#include <gtest/gtest.h>
+
+#include <x86.hpp>
+
+void expect_same_elf( const stig::elf64_x86_64& actual, const stig::elf64_x86_64& expected ) {
+	EXPECT_EQ( actual._init, expected._init );
+	EXPECT_EQ( actual.plt, expected.plt );
+	EXPECT_EQ( actual.plt_got, expected.plt_got );
+	EXPECT_EQ( actual.text, expected.text );
+	EXPECT_EQ( actual.fini, expected.fini );
+	EXPECT_EQ( actual.ranges, expected.ranges );
+}
+
+TEST( UnitTest, DisassemblyCache ) {
+	auto source = stig::map_file( "../test/main_disasm.txt" );
+	ASSERT_TRUE( source ) << source.error();
+	auto elf = stig::parse_disassembly( source.value(), 1 );
+	ASSERT_TRUE( elf ) << elf.error();
+	uint64_t hash = stig::hash_bytes( source->bytes() );
+	std::string cache_name = "test_disassembly_cache.bin";
+	auto written = stig::write_disassembly_cache( cache_name, elf.value(), hash, source->size );
+	ASSERT_TRUE( written ) << written.error();
+
+	auto cache = stig::open_disassembly_cache( cache_name );
+	ASSERT_TRUE( cache ) << cache.error();
+	EXPECT_EQ( cache->header->source_hash, hash );
+	EXPECT_EQ( cache->header->source_size, source->size );
+	auto text = cache->section_functions( stig::elf_section::text );
+	ASSERT_EQ( text.size(), elf->text.size() );
+	EXPECT_EQ( cache->name( text[ 0 ] ), elf->text[ 0 ].name );
+	EXPECT_EQ( cache->to_function( text.back() ), elf->text.back() );
+	expect_same_elf( cache->to_elf(), elf.value() );
+	std::remove( cache_name.c_str() );
+}
+
+TEST( UnitTest, DisassemblyCache_Rejected ) {
+	std::string cache_name = "test_disassembly_cache_bad.bin";
+	{
+		std::ofstream file( cache_name, std::ios::binary );
+		file << "not a cache";
+	}
+	EXPECT_FALSE( stig::open_disassembly_cache( cache_name ) );
+
+	stig::elf64_x86_64 elf;
+	ASSERT_TRUE( stig::write_disassembly_cache( cache_name, elf, 0, 0 ) );
+	EXPECT_TRUE( stig::open_disassembly_cache( cache_name ) );
+	{
+		std::ofstream file( cache_name, std::ios::binary | std::ios::app );
+		file << "trailing";
+	}
+	EXPECT_FALSE( stig::open_disassembly_cache( cache_name ) );
+	std::remove( cache_name.c_str() );
+}
+
+TEST( UnitTest, ParseDisassemblyCached ) {
+	std::string cache_name = "test_parse_disassembly_cached.bin";
+	std::remove( cache_name.c_str() );
+	auto parsed = stig::parse_disassembly( "../test/main_disasm.txt", 1 );
+	ASSERT_TRUE( parsed ) << parsed.error();
+	auto first = stig::parse_disassembly_cached( "../test/main_disasm.txt", cache_name );
+	ASSERT_TRUE( first ) << first.error();
+	expect_same_elf( first.value(), parsed.value() );
+	ASSERT_TRUE( stig::open_disassembly_cache( cache_name ) );
+	auto second = stig::parse_disassembly_cached( "../test/main_disasm.txt", cache_name );
+	ASSERT_TRUE( second ) << second.error();
+	expect_same_elf( second.value(), parsed.value() );
+	std::remove( cache_name.c_str() );
+}
@@ -0,0 +1,45 @@
+#include <gtest/gtest.h>
+
+#include <x86.hpp>
+
+TEST( UnitTest, ElfFile ) {
+	auto elf = stig::open_elf_file( "../test/main" );
+	ASSERT_TRUE( elf ) << elf.error();
+	EXPECT_EQ( elf->header->e_machine, 62 );
+	EXPECT_FALSE( elf->segments.empty() );
+
+	const auto* text = elf->find_section( ".text" );
+	ASSERT_NE( text, nullptr );
+	EXPECT_EQ( elf->section_name( *text ), ".text" );
+	EXPECT_EQ( elf->contents( *text ).size(), text->sh_size );
+	// Zero-copy: section contents point into the mapped image.
+	EXPECT_EQ( elf->contents( *text ).data(), elf->image.data() + text->sh_offset );
+	EXPECT_EQ( elf->find_section( ".does_not_exist" ), nullptr );
+
+	const auto* symtab = elf->find_section( ".symtab" );
+	ASSERT_NE( symtab, nullptr );
+	auto symbols = elf->symbols( *symtab );
+	const auto* strtab = &elf->sections[ symtab->sh_link ];
+	EXPECT_TRUE( std::any_of( symbols.begin(), symbols.end(), [ & ]( const stig::elf64_sym& symbol ) {
+		return elf->string( *strtab, symbol.st_name ) == "main";
+	} ) );
+
+	// The same image borrowed from memory parses identically.
+	auto borrowed = stig::open_elf_image( elf->image );
+	ASSERT_TRUE( borrowed ) << borrowed.error();
+	EXPECT_EQ( borrowed->sections.data(), elf->sections.data() );
+	auto parsed = stig::parse_elf( elf.value() );
+	ASSERT_TRUE( parsed ) << parsed.error();
+	EXPECT_EQ( parsed->text.front().name, "_start" );
+}
+
+TEST( UnitTest, ElfFile_Errors ) {
+	EXPECT_FALSE( stig::open_elf_file( "../test/main_disasm.txt" ) );
+	EXPECT_FALSE( stig::open_elf_file( "../test/does_not_exist" ) );
+	EXPECT_FALSE( stig::get_elf_header( "../test/does_not_exist" ) );
+
+	auto file = stig::open_elf_file( "../test/main" );
+	ASSERT_TRUE( file ) << file.error();
+	std::vector<uint8_t> truncated( file->image.begin(), file->image.begin() + 128 );
+	EXPECT_FALSE( stig::open_elf_image( truncated ) );
+}
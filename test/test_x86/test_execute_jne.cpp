@@ -17,4 +17,19 @@ TEST( UnitTest, ExecuteJne ) {
 	auto get_result = cpu.get( stig::x86_register::rip );
 	ASSERT_TRUE( get_result ) << get_result.error();
 	EXPECT_EQ( get_result.value(), target.addr );
-}
\ No newline at end of file
+}
+
+TEST( UnitTest, ExecuteJne_NotTaken ) {
+	stig::x86_instruction instr = {
+		0x10,
+		std::vector<uint8_t>{ 0x75, 0x2b },
+		stig::x86_mnemonic::jne,
+		std::vector<stig::x86_operand>{ stig::x86_address{ 0x3d } }
+	};
+	stig::x86_cpu cpu{};
+	cpu.rip = 0x10;
+	cpu.zero_flag = true;
+	auto jne_result = stig::execute_jne( instr, cpu );
+	ASSERT_TRUE( jne_result ) << jne_result.error();
+	EXPECT_EQ( cpu.rip, 0x12 );
+}
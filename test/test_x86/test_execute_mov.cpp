@@ -30,9 +30,10 @@ TEST( UnitTest, ExecuteMovb ) {
 		stig::x86_mnemonic::movb,
 		std::vector<stig::x86_operand>{ stig::x86_immediate{ 0x01 }, mem }
 	};
-	stig::x86_vm vm{};
-	vm.cpu.set( stig::x86_register::rip, 0x000000000000000f );
-	auto movb_result = stig::execute_movb( instr, vm.cpu, vm.ram );
+	stig::x86_cpu cpu{};
+	std::unordered_map<uint64_t,uint8_t> ram;
+	cpu.set( stig::x86_register::rip, 0x000000000000000f );
+	auto movb_result = stig::execute_movb( instr, cpu, ram );
 	ASSERT_TRUE( movb_result ) << movb_result.error();
-	EXPECT_EQ( vm.ram[ 0x000000000000000f + 0x2efd ], 0x01 );
+	EXPECT_EQ( ram[ 0x000000000000000f + 0x2efd ], 0x01 );
 }
\ No newline at end of file
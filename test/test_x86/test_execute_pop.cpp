@@ -10,11 +10,14 @@ TEST( UnitTest, ExecutePop ) {
 		std::vector<stig::x86_operand>{ stig::x86_register::rax }
 	};
 	stig::x86_cpu cpu{};
-	for ( int i = 0; i < 8; ++i ) {
-		cpu.stack.push( 0x55 );
-	}
-	auto pop_result = stig::execute_pop( instr, cpu );
+	stig::guest_memory memory;
+	cpu.rsp = stig::guest_stack::top;
+	EXPECT_FALSE( stig::execute_pop( instr, cpu, memory ) );
+	cpu.rsp -= 8;
+	ASSERT_TRUE( memory.store( cpu.rsp, 0x5555555555555555, 8 ) );
+	auto pop_result = stig::execute_pop( instr, cpu, memory );
 	ASSERT_TRUE( pop_result ) << pop_result.error();
 	auto result = cpu.get( stig::x86_register::rax );
 	EXPECT_EQ( result, 0x5555555555555555 );
+	EXPECT_EQ( cpu.rsp, stig::guest_stack::top );
 }
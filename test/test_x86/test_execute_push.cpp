@@ -9,8 +9,13 @@ TEST( UnitTest, ExecutePush ) {
 		stig::x86_mnemonic::push,
 		std::vector<stig::x86_operand>{ stig::x86_register::rax }
 	};
-	stig::x86_cpu cpu;
-	cpu.set( stig::x86_register::rdx, 0x5555555555555555 );
-	stig::execute_push( instr, cpu );
-	EXPECT_EQ( cpu.stack.size(), 8 );
+	stig::x86_cpu cpu{};
+	stig::guest_memory memory;
+	cpu.rsp = stig::guest_stack::top;
+	cpu.set( stig::x86_register::rax, 0x1122334455667788 );
+	auto push_result = stig::execute_push( instr, cpu, memory );
+	ASSERT_TRUE( push_result ) << push_result.error();
+	EXPECT_EQ( cpu.rsp, stig::guest_stack::top - 8 );
+	EXPECT_EQ( memory.load( cpu.rsp, 8 ), 0x1122334455667788 );
+	EXPECT_EQ( memory.load( cpu.rsp, 1 ), 0x88 );
 }
@@ -10,18 +10,17 @@ TEST( UnitTest, ExecuteRet ) {
 		std::nullopt
 	};
 	stig::x86_cpu cpu{};
+	stig::guest_memory memory;
 	auto set_rip_result = cpu.set( stig::x86_register::rip, 0x80000000ffffffff );
 	ASSERT_TRUE( set_rip_result ) << set_rip_result.error();
-	cpu.stack.push( 0x00 );
-	cpu.stack.push( 0x00 );
-	cpu.stack.push( 0x00 );
-	cpu.stack.push( 0x00 );
-	cpu.stack.push( 0x00 );
-	cpu.stack.push( 0x00 );
-	cpu.stack.push( 0xff );
-	cpu.stack.push( 0xff );
-	auto ret_result = stig::execute_ret( instr, cpu );
+	EXPECT_FALSE( stig::execute_ret( instr, cpu, memory ) );
+	cpu.rsp = stig::guest_stack::top;
+	EXPECT_FALSE( stig::execute_ret( instr, cpu, memory ) );
+	cpu.rsp -= 8;
+	ASSERT_TRUE( memory.store( cpu.rsp, 0x000000000000ffff, 8 ) );
+	auto ret_result = stig::execute_ret( instr, cpu, memory );
 	ASSERT_TRUE( ret_result ) << ret_result.error();
 	auto get_result = cpu.get( stig::x86_register::rip );
 	EXPECT_EQ( get_result.value(), 0x000000000000ffff );
-} 
\ No newline at end of file
+	EXPECT_EQ( cpu.rsp, stig::guest_stack::top );
+}
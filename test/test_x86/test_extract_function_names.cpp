@@ -9,4 +9,14 @@ TEST( UnitTest, ExtractFunctionNames ) {
 		auto res = stig::extract_function( "../test/main_static.txt", str );
 		ASSERT_TRUE( res ) << str << ": " << res.error();
 	}
-}
\ No newline at end of file
+}
+
+TEST( UnitTest, MatchFunctionHeader ) {
+	EXPECT_EQ( stig::match_function_header( "0000000000001141 <main>:" ), "main" );
+	EXPECT_EQ( stig::match_function_header( "0000000000001030 <__cxa_finalize@plt>:  " ), "__cxa_finalize@plt" );
+	EXPECT_EQ( stig::match_function_header( "0000000000001000 <std::vector<int>::size>:" ), "std::vector<int>::size" );
+	EXPECT_EQ( stig::match_function_header( "1141 <main>:" ), std::nullopt );
+	EXPECT_EQ( stig::match_function_header( "    1141:	c3                   	ret" ), std::nullopt );
+	EXPECT_EQ( stig::match_function_header( "Disassembly of section .text:" ), std::nullopt );
+	EXPECT_EQ( stig::match_function_header( "0000000000001141 <main>" ), std::nullopt );
+}
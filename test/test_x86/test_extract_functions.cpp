@@ -0,0 +1,20 @@
+#include <gtest/gtest.h>
+
+#include <x86.hpp>
+
+#include "test_constants.hpp"
+
+TEST( UnitTest, ExtractFunctions ) {
+	auto res = stig::extract_functions( "../test/main_disasm.txt", { "_init", "main", "_Z3addii" } );
+	ASSERT_TRUE( res ) << res.error();
+	auto& functions = res.value();
+	ASSERT_EQ( functions.size(), 3 );
+	EXPECT_EQ( functions[ 0 ].name, "_init" );
+	EXPECT_EQ( functions[ 1 ], test::expected_main );
+	EXPECT_EQ( functions[ 2 ].instructions.size(), 10 );
+}
+
+TEST( UnitTest, ExtractFunctions_Missing ) {
+	auto res = stig::extract_functions( "../test/main_disasm.txt", { "main", "not_a_function" } );
+	EXPECT_FALSE( res );
+}
@@ -0,0 +1,38 @@
+#include <gtest/gtest.h>
+
+#include <x86.hpp>
+
+static_assert( stig::get_register( "%rax" ) == stig::x86_register::rax );
+static_assert( stig::get_mnemonic( "cmpxchg" ) == stig::x86_mnemonic::cmpxchg );
+
+TEST( UnitTest, GetRegister ) {
+	EXPECT_EQ( stig::get_register( "%rdx" ), stig::x86_register::rdx );
+	EXPECT_EQ( stig::get_register( "%r8d" ), stig::x86_register::r8d );
+	EXPECT_EQ( stig::get_register( "%sil" ), stig::x86_register::sil );
+	EXPECT_EQ( stig::get_register( "%xmm15" ), stig::x86_register::xmm15 );
+	EXPECT_EQ( stig::get_register( "%fs" ), stig::x86_register::fs );
+	EXPECT_EQ( stig::get_register( "rax" ), std::nullopt );
+	EXPECT_EQ( stig::get_register( "%rax,%rbx" ), std::nullopt );
+	EXPECT_EQ( stig::get_register( "" ), std::nullopt );
+	for ( std::size_t i = 0; i < stig::register_table.keys.size(); ++i ) {
+		EXPECT_EQ( stig::get_register( stig::register_table.keys[ i ] ), stig::register_table.values[ i ] );
+	}
+}
+
+TEST( UnitTest, GetRegisterWidth ) {
+	EXPECT_EQ( stig::get_register_width( stig::x86_register::r15 ), 64 );
+	EXPECT_EQ( stig::get_register_width( stig::x86_register::edi ), 32 );
+	EXPECT_EQ( stig::get_register_width( stig::x86_register::r9w ), 16 );
+	EXPECT_EQ( stig::get_register_width( stig::x86_register::ah ), 8 );
+	EXPECT_EQ( stig::get_register_width( stig::x86_register::rip ), 64 );
+}
+
+TEST( UnitTest, GetMnemonic ) {
+	for ( std::size_t i = 0; i < stig::mnemonic_table.keys.size(); ++i ) {
+		EXPECT_EQ( stig::get_mnemonic( stig::mnemonic_table.keys[ i ] ), stig::mnemonic_table.values[ i ] );
+		EXPECT_EQ( stig::mnemonic_names.at( stig::mnemonic_table.values[ i ] ), stig::mnemonic_table.keys[ i ] );
+		EXPECT_EQ( stig::mnemonic_name( stig::mnemonic_table.values[ i ] ), stig::mnemonic_table.keys[ i ] );
+	}
+	static_assert( stig::mnemonic_name( stig::x86_mnemonic::xor_ ) == "xor" );
+	EXPECT_EQ( stig::get_mnemonic( "leave" ), std::nullopt );
+}
@@ -0,0 +1,170 @@
+#include <gtest/gtest.h>
+
+#include <x86.hpp>
+
+#include "program_builder.hpp"
+
+TEST( UnitTest, GuestMemory ) {
+	auto elf = stig::open_elf_file( "../test/main" );
+	ASSERT_TRUE( elf ) << elf.error();
+	auto memory = stig::load_segments( elf.value() );
+	ASSERT_TRUE( memory ) << memory.error();
+	ASSERT_FALSE( memory->segments.empty() );
+
+	// Read-only segments are read in place from the mapped file.
+	const auto* text = elf->find_section( ".text" );
+	ASSERT_NE( text, nullptr );
+	std::vector<uint8_t> bytes( 16 );
+	ASSERT_TRUE( memory->read( text->sh_addr, bytes ) );
+	auto contents = elf->contents( *text );
+	EXPECT_TRUE( std::equal( bytes.begin(), bytes.end(), contents.begin() ) );
+	EXPECT_FALSE( memory->store( text->sh_addr, 0xcc, 1 ) );
+	EXPECT_FALSE( memory->load( memory->segments.back().address + memory->segments.back().size, 8 ) );
+
+	// Writes copy the page; the image itself is never modified.
+	const auto* data = elf->find_section( ".data" );
+	ASSERT_NE( data, nullptr );
+	uint64_t original = 0;
+	std::memcpy( &original, elf->contents( *data ).data(), sizeof( original ) );
+	EXPECT_EQ( memory->load( data->sh_addr, 8 ), original );
+	EXPECT_EQ( memory->private_pages(), 0 );
+	ASSERT_TRUE( memory->store( data->sh_addr, 0x1122334455667788, 8 ) );
+	EXPECT_EQ( memory->load( data->sh_addr, 8 ), 0x1122334455667788 );
+	EXPECT_EQ( memory->load( data->sh_addr, 2 ), 0x7788 );
+	EXPECT_EQ( memory->private_pages(), 1 );
+	uint64_t after = 0;
+	std::memcpy( &after, elf->contents( *data ).data(), sizeof( after ) );
+	EXPECT_EQ( after, original );
+
+	// .bss has no file bytes and reads as zero until written.
+	const auto* bss = elf->find_section( ".bss" );
+	ASSERT_NE( bss, nullptr );
+	EXPECT_EQ( memory->load( bss->sh_addr, 1 ), 0 );
+	ASSERT_TRUE( memory->store( bss->sh_addr, 0x5a, 1 ) );
+	EXPECT_EQ( memory->load( bss->sh_addr, 1 ), 0x5a );
+}
+
+TEST( UnitTest, GuestMemory_ExecuteMov ) {
+	auto elf = stig::open_elf_file( "../test/main" );
+	ASSERT_TRUE( elf ) << elf.error();
+	auto parsed = stig::parse_elf( elf.value() );
+	ASSERT_TRUE( parsed ) << parsed.error();
+	stig::x86_vm vm{};
+	auto memory = stig::load_segments( elf.value() );
+	ASSERT_TRUE( memory ) << memory.error();
+	vm.memory = std::move( memory.value() );
+
+	// _init loads __gmon_start__'s GOT slot with mov disp(%rip),%rax.
+	auto init = parsed->_init.front();
+	auto mov = std::find_if( init.instructions.begin(), init.instructions.end(), []( const stig::x86_instruction& instruction ) {
+		return instruction.mnemonic == stig::x86_mnemonic::mov && std::holds_alternative<stig::x86_memory>( instruction.operands->front() );
+	} );
+	ASSERT_NE( mov, init.instructions.end() );
+	auto slot = mov->address + mov->machine_bytes.size() + std::get<stig::x86_memory>( mov->operands->front() ).displacement.value();
+	ASSERT_TRUE( vm.memory.store( slot, 0xdeadbeef, 8 ) );
+	vm.cpu.rax = 0;
+	auto result = stig::execute_mov( *mov, vm.cpu, vm.memory );
+	ASSERT_TRUE( result ) << result.error();
+	EXPECT_EQ( vm.cpu.rax, 0xdeadbeef );
+
+	// And back out to memory.
+	stig::x86_instruction store{ 0, std::vector<uint8_t>{ 0x48, 0x89, 0x05, 0, 0, 0, 0 }, stig::x86_mnemonic::mov,
+								 std::vector<stig::x86_operand>{ stig::x86_register::rax, stig::x86_memory{ stig::x86_register::rip, std::nullopt, std::nullopt, static_cast<int64_t>( slot - 7 + 8 ) } } };
+	ASSERT_TRUE( stig::execute_mov( store, vm.cpu, vm.memory ) );
+	EXPECT_EQ( vm.memory.load( slot + 8, 8 ), 0xdeadbeef );
+}
+
+TEST( UnitTest, GuestMemory_MovbThenCmpb ) {
+	auto elf = stig::open_elf_file( "../test/main" );
+	ASSERT_TRUE( elf ) << elf.error();
+	auto memory = stig::load_segments( elf.value() );
+	ASSERT_TRUE( memory ) << memory.error();
+	const auto* bss = elf->find_section( ".bss" );
+	ASSERT_NE( bss, nullptr );
+	stig::x86_vm vm{};
+	vm.memory = std::move( memory.value() );
+
+	// __do_global_dtors_aux's guard: movb $0x1,x(%rip) is seen by a later cmpb $0x0,x(%rip).
+	auto rip_relative = [ & ]( uint64_t address ) {
+		return stig::x86_memory{ stig::x86_register::rip, std::nullopt, std::nullopt, static_cast<int64_t>( bss->sh_addr - address - 7 ) };
+	};
+	stig::x86_instruction movb{ 0x1000, std::vector<uint8_t>( 7 ), stig::x86_mnemonic::movb,
+								std::vector<stig::x86_operand>{ stig::x86_immediate{ 1 }, rip_relative( 0x1000 ) } };
+	stig::x86_instruction cmpb{ 0x1100, std::vector<uint8_t>( 7 ), stig::x86_mnemonic::cmpb,
+								std::vector<stig::x86_operand>{ stig::x86_immediate{ 0 }, rip_relative( 0x1100 ) } };
+	ASSERT_TRUE( vm.execute_instruction( cmpb ) );
+	EXPECT_TRUE( vm.cpu.zero_flag );
+	auto result = vm.execute_instruction( movb );
+	ASSERT_TRUE( result ) << result.error();
+	EXPECT_EQ( vm.memory.load( bss->sh_addr, 1 ), 1 );
+	ASSERT_TRUE( vm.execute_instruction( cmpb ) );
+	EXPECT_FALSE( vm.cpu.zero_flag );
+}
+
+TEST( UnitTest, GuestMemory_CallThroughMemory ) {
+	auto elf = stig::open_elf_file( "../test/main" );
+	ASSERT_TRUE( elf ) << elf.error();
+	auto memory = stig::load_segments( elf.value() );
+	ASSERT_TRUE( memory ) << memory.error();
+	const auto* bss = elf->find_section( ".bss" );
+	ASSERT_NE( bss, nullptr );
+	stig::x86_vm vm{};
+	vm.memory = std::move( memory.value() );
+
+	// call *disp(%rip), the way _start reaches __libc_start_main through its GOT slot.
+	ASSERT_TRUE( vm.memory.store( bss->sh_addr, 0x4242, 8 ) );
+	stig::x86_memory slot{ stig::x86_register::rip, std::nullopt, std::nullopt, static_cast<int64_t>( bss->sh_addr - 0x1006 ) };
+	stig::x86_instruction call{ 0x1000, std::vector<uint8_t>( 6 ), stig::x86_mnemonic::call, std::vector<stig::x86_operand>{ slot } };
+	auto result = vm.execute_instruction( call );
+	ASSERT_TRUE( result ) << result.error();
+	EXPECT_EQ( vm.cpu.rip, 0x4242 );
+	EXPECT_EQ( vm.cpu.rsp, stig::guest_stack::top - 8 );
+	EXPECT_EQ( vm.memory.load( vm.cpu.rsp, 8 ), 0x1006 );
+}
+
+TEST( UnitTest, GuestMemory_Stack ) {
+	using stig::x86_mnemonic;
+	using stig::x86_register;
+	// A frame-pointer prologue, a store and load through %rbp and %rsp, a call and the
+	// epilogue, run from a fresh VM whose rsp starts at the stack top.
+	program_builder b;
+	b.add( 1, x86_mnemonic::push, { x86_register::rbp } );
+	b.add( 3, x86_mnemonic::mov, { x86_register::rsp, x86_register::rbp } );
+	b.add( 4, x86_mnemonic::mov, { x86_register::rdi, at( x86_register::rbp, -8 ) } );
+	b.add( 4, x86_mnemonic::add, { stig::x86_immediate{ -16 }, x86_register::rsp } );
+	b.add( 5, x86_mnemonic::call, { stig::x86_address{ 0x40 } } );
+	b.add( 4, x86_mnemonic::mov, { at( x86_register::rsp, 8 ), x86_register::rax } );
+	b.add( 4, x86_mnemonic::add, { stig::x86_immediate{ 16 }, x86_register::rsp } );
+	b.add( 1, x86_mnemonic::pop, { x86_register::rbp } );
+	uint64_t exit = b.address;
+	b.address = 0x40;
+	b.add( 5, x86_mnemonic::mov, { at( x86_register::rsp, 0 ), x86_register::rsi } );
+	b.add( 1, x86_mnemonic::ret, {} );
+	auto prog = stig::convert_to_program( b.func );
+	ASSERT_TRUE( prog ) << prog.error();
+	prog->entry_point = 0;
+	prog->exit_point = exit;
+
+	stig::x86_vm vm{};
+	vm.cpu.rbp = 0x1234;
+	vm.cpu.rdi = 0x5678;
+	auto result = vm.load_program( prog.value() );
+	ASSERT_TRUE( result ) << result.error();
+	EXPECT_EQ( vm.cpu.rax, 0x5678 );
+	EXPECT_EQ( vm.cpu.rsi, 0x11 );  // the return address the callee saw at (%rsp)
+	EXPECT_EQ( vm.cpu.rbp, 0x1234 );
+	EXPECT_EQ( vm.cpu.rsp, stig::guest_stack::top );
+	EXPECT_EQ( vm.memory.stack.bytes.size(), stig::guest_memory::page_size );
+
+	// The stack is plain guest memory: readable by address, growing down as needed,
+	// and bounded by its limit.
+	EXPECT_EQ( vm.memory.load( stig::guest_stack::top - 8, 8 ), 0x1234 );
+	uint64_t deep = stig::guest_stack::top - stig::guest_stack::limit;
+	EXPECT_EQ( vm.memory.load( deep, 8 ), 0 );
+	ASSERT_TRUE( vm.memory.store( deep, 0xabcd, 8 ) );
+	EXPECT_EQ( vm.memory.load( deep, 8 ), 0xabcd );
+	EXPECT_EQ( vm.memory.load( stig::guest_stack::top - 8, 8 ), 0x1234 );
+	EXPECT_EQ( vm.memory.stack.bytes.size(), stig::guest_stack::limit );
+	EXPECT_FALSE( vm.memory.store( deep - 8, 0, 8 ) );
+	EXPECT_FALSE( vm.memory.load( stig::guest_stack::top, 8 ) );
+}
@@ -0,0 +1,59 @@
+#include <gtest/gtest.h>
+
+#include <x86.hpp>
+
+TEST( UnitTest, InstructionStore ) {
+	auto elf = stig::parse_disassembly( "../test/main_disasm.txt", 1 );
+	ASSERT_TRUE( elf ) << elf.error();
+	auto built = stig::build_instruction_store( elf.value() );
+	ASSERT_TRUE( built ) << built.error();
+	auto parsed = stig::parse_instruction_store( "../test/main_disasm.txt" );
+	ASSERT_TRUE( parsed ) << parsed.error();
+	EXPECT_EQ( parsed->addresses, built->addresses );
+	EXPECT_EQ( parsed->bytes, built->bytes );
+	EXPECT_EQ( parsed->operand_values, built->operand_values );
+	EXPECT_EQ( parsed->function_names, built->function_names );
+	ASSERT_EQ( parsed->function_count(), 11 );
+	EXPECT_EQ( parsed->function_names.front(), "_init" );
+	EXPECT_EQ( parsed->function_sections.back(), stig::elf_section::fini );
+
+	std::vector<uint64_t> calls;
+	std::size_t instruction_count = 0;
+	for ( auto section : { stig::elf_section::init, stig::elf_section::plt, stig::elf_section::plt_got, stig::elf_section::text, stig::elf_section::fini } ) {
+		for ( const auto& func : *elf->functions( section ) ) {
+			for ( const auto& instruction : func.instructions ) {
+				auto compact = stig::convert_to_compact( instruction );
+				ASSERT_TRUE( compact ) << compact.error();
+				EXPECT_EQ( parsed->compact( instruction_count++ ), compact.value() );
+				if ( instruction.mnemonic == stig::x86_mnemonic::call ) {
+					calls.push_back( instruction.address );
+				}
+			}
+		}
+	}
+	ASSERT_EQ( parsed->size(), instruction_count );
+	EXPECT_FALSE( calls.empty() );
+	EXPECT_EQ( parsed->addresses_of( stig::x86_mnemonic::call ), calls );
+	EXPECT_EQ( parsed->count( stig::x86_mnemonic::call ), calls.size() );
+	for ( auto index : parsed->find( stig::x86_mnemonic::call ) ) {
+		EXPECT_EQ( parsed->mnemonics[ index ], stig::x86_mnemonic::call );
+	}
+}
+
+TEST( UnitTest, InstructionStore_Scan ) {
+	stig::instruction_store store;
+	store.add_function( "f", stig::elf_section::text );
+	std::vector<uint32_t> expected;
+	for ( uint32_t i = 0; i < 200; ++i ) {
+		stig::x86_compact_instruction instruction;
+		instruction.address = 0x1000 + i;
+		instruction.mnemonic = i % 7 == 0 ? stig::x86_mnemonic::ret : stig::x86_mnemonic::nopl;
+		if ( instruction.mnemonic == stig::x86_mnemonic::ret ) {
+			expected.push_back( i );
+		}
+		store.push_back( instruction );
+	}
+	EXPECT_EQ( store.find( stig::x86_mnemonic::ret ), expected );
+	EXPECT_EQ( store.count( stig::x86_mnemonic::nopl ), 200 - expected.size() );
+	EXPECT_TRUE( store.find( stig::x86_mnemonic::hlt ).empty() );
+}
@@ -0,0 +1,118 @@
+#include <gtest/gtest.h>
+
+#include <x86.hpp>
+
+#include "program_builder.hpp"
+
+TEST( UnitTest, Jit_Loop ) {
+	using stig::x86_mnemonic;
+	using stig::x86_register;
+	// Sums a shifting pattern into rax while rdx counts down to zero.
+	program_builder b;
+	b.add( 7, x86_mnemonic::mov, { stig::x86_immediate{ 100000 }, x86_register::rdx } );
+	b.add( 3, x86_mnemonic::xor_, { x86_register::rax, x86_register::rax } );
+	uint64_t loop = b.address;
+	b.add( 4, x86_mnemonic::lea, { at( x86_register::rax, 7 ), x86_register::rsi } );
+	b.add( 4, x86_mnemonic::and_, { stig::x86_immediate{ 0xfff }, x86_register::rsi } );
+	b.add( 3, x86_mnemonic::xor_, { x86_register::rsi, x86_register::rax } );
+	b.add( 3, x86_mnemonic::mov, { x86_register::rax, x86_register::r9 } );
+	b.add( 2, x86_mnemonic::xor_, { x86_register::edx, x86_register::ebp } );
+	b.add( 4, x86_mnemonic::add, { stig::x86_immediate{ -1 }, x86_register::rdx } );
+	b.add( 3, x86_mnemonic::test, { x86_register::rdx, x86_register::rdx } );
+	b.add( 2, x86_mnemonic::jne, { stig::x86_address{ loop } } );
+	uint64_t exit = b.address;
+	auto prog = stig::convert_to_program( b.func );
+	ASSERT_TRUE( prog ) << prog.error();
+	auto table = stig::lower_program( prog.value() );
+	ASSERT_TRUE( table ) << table.error();
+
+	stig::block_cache interpreted_cache{ &table.value(), exit };
+	stig::x86_vm interpreted{};
+	auto expected = interpreted.run( interpreted_cache, 0 );
+	ASSERT_TRUE( expected ) << expected.error();
+
+	for ( bool verify : { true, false } ) {
+		stig::block_cache cache{ &table.value(), exit };
+		cache.jit_threshold = 2;
+		cache.verify_jit = verify;
+		stig::x86_vm vm{};
+		auto result = vm.run( cache, 0 );
+		ASSERT_TRUE( result ) << result.error();
+		EXPECT_EQ( result.value(), expected.value() );
+		EXPECT_EQ( vm.cpu.rax, interpreted.cpu.rax );
+		EXPECT_EQ( vm.cpu.rbp, interpreted.cpu.rbp );
+		EXPECT_EQ( vm.cpu.r9, interpreted.cpu.r9 );
+		EXPECT_EQ( vm.cpu.rsi, interpreted.cpu.rsi );
+		EXPECT_EQ( vm.cpu.rdx, 0 );
+		EXPECT_EQ( vm.cpu.rip, exit );
+		EXPECT_EQ( vm.cpu.zero_flag, interpreted.cpu.zero_flag );
+
+		const auto& body = cache.blocks.at( loop );
+		EXPECT_NE( body.compiled, nullptr );
+		EXPECT_EQ( body.executions, interpreted_cache.blocks.at( loop ).executions );
+		// The entry block runs straight into the first pass of the loop.
+		EXPECT_EQ( body.executions, 99999 );
+	}
+}
+
+TEST( UnitTest, Jit_Flags ) {
+	using stig::x86_mnemonic;
+	using stig::x86_register;
+	const int64_t values[] = { 0, 1, -1, 0x7fffffffffffffff, static_cast<int64_t>( 0x8000000000000000 ), 0x80000000, 0xffffffff, 42 };
+	for ( auto lhs : values ) {
+		for ( auto rhs : values ) {
+			for ( auto mnemonic : { x86_mnemonic::cmp, x86_mnemonic::test, x86_mnemonic::and_ } ) {
+				// The compared block ends in a jmp so every flag it sets is checked against the interpreter.
+				program_builder b;
+				b.add( 10, x86_mnemonic::mov, { stig::x86_immediate{ lhs }, x86_register::rax } );
+				b.add( 10, x86_mnemonic::mov, { stig::x86_immediate{ rhs }, x86_register::rsi } );
+				b.add( 3, x86_mnemonic::mov, { x86_register::rax, x86_register::rdx } );
+				b.add( 2, x86_mnemonic::mov, { x86_register::edx, x86_register::ebp } );
+				b.add( 3, mnemonic, { x86_register::rsi, x86_register::rax } );
+				b.add( 2, x86_mnemonic::jmp, { stig::x86_address{ 0x40 } } );
+				b.address = 0x40;
+				b.add( 4, x86_mnemonic::add, { stig::x86_immediate{ -1 }, x86_register::rdi } );
+				b.add( 3, x86_mnemonic::test, { x86_register::rdi, x86_register::rdi } );
+				b.add( 2, x86_mnemonic::jne, { stig::x86_address{ 0 } } );
+				uint64_t exit = b.address;
+				auto prog = stig::convert_to_program( b.func );
+				ASSERT_TRUE( prog ) << prog.error();
+				auto table = stig::lower_program( prog.value() );
+				ASSERT_TRUE( table ) << table.error();
+				stig::block_cache cache{ &table.value(), exit };
+				cache.jit_threshold = 1;
+				cache.verify_jit = true;
+				stig::x86_vm vm{};
+				vm.cpu.rdi = 3;
+				auto result = vm.run( cache, 0 );
+				ASSERT_TRUE( result ) << std::hex << lhs << " " << rhs << ": " << result.error();
+				EXPECT_NE( cache.blocks.at( 0 ).compiled, nullptr );
+				EXPECT_NE( cache.blocks.at( 0x40 ).compiled, nullptr );
+			}
+		}
+	}
+}
+
+TEST( UnitTest, Jit_Uncompilable ) {
+	using stig::x86_mnemonic;
+	using stig::x86_register;
+	program_builder b;
+	b.add( 1, x86_mnemonic::push, { x86_register::rax } );
+	b.add( 1, x86_mnemonic::pop, { x86_register::rax } );
+	b.add( 4, x86_mnemonic::add, { stig::x86_immediate{ -1 }, x86_register::rdx } );
+	b.add( 3, x86_mnemonic::test, { x86_register::rdx, x86_register::rdx } );
+	b.add( 2, x86_mnemonic::jne, { stig::x86_address{ 0 } } );
+	auto prog = stig::convert_to_program( b.func );
+	ASSERT_TRUE( prog ) << prog.error();
+	auto table = stig::lower_program( prog.value() );
+	ASSERT_TRUE( table ) << table.error();
+	stig::block_cache cache{ &table.value(), b.address };
+	cache.jit_threshold = 1;
+	stig::x86_vm vm{};
+	vm.cpu.rdx = 10;
+	auto result = vm.run( cache, 0 );
+	ASSERT_TRUE( result ) << result.error();
+	EXPECT_EQ( cache.blocks.at( 0 ).compiled, nullptr );
+	EXPECT_TRUE( cache.blocks.at( 0 ).uncompilable );
+	EXPECT_EQ( cache.blocks.at( 0 ).executions, 10 );
+}
@@ -0,0 +1,55 @@
+#include <gtest/gtest.h>
+
+#include <x86.hpp>
+
+std::vector<std::string_view> scan_lines( std::string_view text ) {
+	std::vector<std::string_view> lines;
+	stig::line_scanner scanner( text );
+	while ( scanner.has_next() ) {
+		lines.push_back( scanner.next() );
+	}
+	return lines;
+}
+
+std::vector<std::string_view> split_lines_view( std::string_view text ) {
+	std::vector<std::string_view> lines;
+	std::size_t pos = 0;
+	while ( pos < text.size() ) {
+		lines.push_back( stig::next_line_view( text, pos ) );
+	}
+	return lines;
+}
+
+TEST( UnitTest, LineScanner ) {
+	std::vector<std::string> texts = {
+		"",
+		"\n",
+		"a\n\nb",
+		"a\nb\n",
+		"no newline",
+		std::string( 63, 'x' ) + "\n" + std::string( 70, 'y' ) + "\nz",
+		std::string( 64, 'x' ) + "\n" + std::string( 128, '\n' ),
+	};
+	for ( const auto& text : texts ) {
+		EXPECT_EQ( scan_lines( text ), split_lines_view( text ) ) << text;
+	}
+	std::ifstream stream( "../test/main_disasm.txt", std::ios::binary );
+	std::string disasm( ( std::istreambuf_iterator<char>( stream ) ), std::istreambuf_iterator<char>() );
+	EXPECT_EQ( scan_lines( disasm ), split_lines_view( disasm ) );
+}
+
+TEST( UnitTest, LineScanner_TabbedBytes ) {
+	auto tabbed = stig::parse_x86_instruction_view( "    1149:\t48 89 e5             \tmov    %rsp,%rbp" );
+	auto spaced = stig::parse_x86_instruction_view( "    1149: 48 89 e5 mov %rsp,%rbp" );
+	ASSERT_TRUE( tabbed ) << tabbed.error();
+	ASSERT_TRUE( spaced ) << spaced.error();
+	EXPECT_EQ( tabbed->machine_bytes, ( std::pmr::vector<uint8_t>{ 0x48, 0x89, 0xe5 } ) );
+	EXPECT_EQ( tabbed->machine_bytes, spaced->machine_bytes );
+	EXPECT_EQ( tabbed->mnemonic, stig::x86_mnemonic::mov );
+	auto locked = stig::parse_x86_instruction_view( "  4011d1:\tf0 0f b1 15 2f 2e 00 00\tlock cmpxchg %edx,0x2e2f(%rip)" );
+	ASSERT_TRUE( locked ) << locked.error();
+	EXPECT_EQ( locked->machine_bytes.size(), 8 );
+	auto padding = stig::parse_x86_instruction_view( "    1005:\t00 00" );
+	ASSERT_TRUE( padding ) << padding.error();
+	EXPECT_EQ( padding->mnemonic, stig::x86_mnemonic::padding );
+}
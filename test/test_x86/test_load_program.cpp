@@ -0,0 +1,70 @@
+#include <gtest/gtest.h>
+
+#include <x86.hpp>
+
+// Counts rax up to rdx:
+//   0: add $0x1,%rax
+//   4: cmp %rdx,%rax
+//   7: jne 0
+//   9: (exit)
+static stig::function counting_loop() {
+	stig::function func;
+	func.name = "count";
+	func.instructions.push_back( { 0, std::vector<uint8_t>{ 0x48, 0x83, 0xc0, 0x01 }, stig::x86_mnemonic::add,
+								   std::vector<stig::x86_operand>{ stig::x86_immediate{ 1 }, stig::x86_register::rax } } );
+	func.instructions.push_back( { 4, std::vector<uint8_t>{ 0x48, 0x39, 0xd0 }, stig::x86_mnemonic::cmp,
+								   std::vector<stig::x86_operand>{ stig::x86_register::rdx, stig::x86_register::rax } } );
+	func.instructions.push_back( { 7, std::vector<uint8_t>{ 0x75, 0xf7 }, stig::x86_mnemonic::jne,
+								   std::vector<stig::x86_operand>{ stig::x86_address{ 0 } } } );
+	return func;
+}
+
+TEST( UnitTest, LoadProgram ) {
+	auto func = counting_loop();
+	auto prog = stig::convert_to_program( func );
+	ASSERT_TRUE( prog ) << prog.error();
+	prog->exit_point = 9;
+
+	auto table = stig::lower_program( prog.value() );
+	ASSERT_TRUE( table ) << table.error();
+	EXPECT_EQ( table->base, 0 );
+	ASSERT_EQ( table->steps.size(), 3 );
+	EXPECT_EQ( table->find( 4 ), 1 );
+	EXPECT_EQ( table->find( 5 ), stig::dispatch_table::no_step );
+	EXPECT_EQ( table->steps[ 0 ].next, 1 );
+	EXPECT_EQ( table->steps[ 2 ].next, stig::dispatch_table::no_step );
+	EXPECT_TRUE( table->steps[ 2 ].branches );
+
+	stig::x86_vm vm{};
+	vm.cpu.rax = 0;
+	vm.cpu.rdx = 1000;
+	auto result = vm.load_program( prog.value() );
+	ASSERT_TRUE( result ) << result.error();
+	EXPECT_EQ( result.value(), 1000 );
+	EXPECT_EQ( vm.cpu.rip, 9 );
+}
+
+TEST( UnitTest, LoadProgram_Errors ) {
+	auto func = counting_loop();
+	auto prog = stig::convert_to_program( func );
+	ASSERT_TRUE( prog ) << prog.error();
+
+	// Falling off the end without reaching exit_point stops instead of inserting a
+	// default instruction.
+	prog->exit_point = 0x100;
+	stig::x86_vm vm{};
+	vm.cpu.rdx = 1;
+	auto missing = vm.load_program( prog.value() );
+	ASSERT_FALSE( missing );
+	EXPECT_EQ( missing.error(), "No Instruction at 0x9" );
+	EXPECT_EQ( prog->instrs.size(), 3 );
+
+	// A failing instruction stops execution with its error.
+	prog->instrs.emplace( 9, stig::x86_instruction{ 9, std::vector<uint8_t>{ 0xf4 }, stig::x86_mnemonic::hlt, std::nullopt } );
+	stig::x86_vm halted{};
+	halted.cpu.rdx = 1;
+	auto hlt = halted.load_program( prog.value() );
+	ASSERT_FALSE( hlt );
+	EXPECT_EQ( hlt.error(), "Privileged Instruction: hlt" );
+	EXPECT_EQ( halted.cpu.rip, 9 );
+}
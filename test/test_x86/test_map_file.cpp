@@ -0,0 +1,29 @@
+#include <gtest/gtest.h>
+
+#include <x86.hpp>
+
+#include "test_constants.hpp"
+
+TEST( UnitTest, MapFile ) {
+	auto file_result = stig::map_file( "../test/main_disasm.txt" );
+	ASSERT_TRUE( file_result ) << file_result.error();
+	auto& file = file_result.value();
+	std::ifstream stream( "../test/main_disasm.txt", std::ios::binary );
+	std::string expected( ( std::istreambuf_iterator<char>( stream ) ), std::istreambuf_iterator<char>() );
+	EXPECT_EQ( file.text(), expected );
+	auto names = stig::extract_function_names( file );
+	ASSERT_TRUE( names ) << names.error();
+	ASSERT_EQ( names->size(), 11 );
+	EXPECT_EQ( names->front(), "_init" );
+	EXPECT_EQ( names->back(), "_fini" );
+	auto index = stig::build_function_index( file );
+	ASSERT_TRUE( index ) << index.error();
+	auto res = stig::extract_function( file, index.value(), "main" );
+	ASSERT_TRUE( res ) << res.error();
+	EXPECT_EQ( res.value(), test::expected_main );
+}
+
+TEST( UnitTest, MapFile_Missing ) {
+	auto file_result = stig::map_file( "../test/does_not_exist.txt" );
+	EXPECT_FALSE( file_result );
+}
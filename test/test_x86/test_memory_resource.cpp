@@ -0,0 +1,57 @@
+#include <gtest/gtest.h>
+
+#include <x86.hpp>
+
+#include "test_constants.hpp"
+
+// Counts the blocks a monotonic arena asks its upstream for.
+struct counting_resource : std::pmr::memory_resource {
+	std::size_t allocations = 0;
+
+	void* do_allocate( std::size_t bytes, std::size_t alignment ) override {
+		++allocations;
+		return std::pmr::new_delete_resource()->allocate( bytes, alignment );
+	}
+
+	void do_deallocate( void* p, std::size_t bytes, std::size_t alignment ) override {
+		std::pmr::new_delete_resource()->deallocate( p, bytes, alignment );
+	}
+
+	bool do_is_equal( const std::pmr::memory_resource& other ) const noexcept override {
+		return this == &other;
+	}
+};
+
+TEST( UnitTest, ParseDisassembly_MemoryResource ) {
+	auto expected = stig::parse_disassembly( "../test/main_disasm.txt", 1 );
+	ASSERT_TRUE( expected ) << expected.error();
+
+	counting_resource upstream;
+	std::pmr::monotonic_buffer_resource arena( &upstream );
+	auto elf = stig::parse_disassembly( "../test/main_disasm.txt", 1, &arena );
+	ASSERT_TRUE( elf ) << elf.error();
+	EXPECT_EQ( elf->text, expected->text );
+	std::size_t instruction_count = 0;
+	for ( const auto& func : elf->text ) {
+		EXPECT_EQ( func.get_allocator().resource(), &arena );
+		for ( const auto& instruction : func.instructions ) {
+			EXPECT_EQ( instruction.machine_bytes.get_allocator().resource(), &arena );
+			if ( instruction.operands ) {
+				EXPECT_EQ( instruction.operands->get_allocator().resource(), &arena );
+			}
+			++instruction_count;
+		}
+	}
+	EXPECT_GT( instruction_count, 50 );
+	EXPECT_LT( upstream.allocations, 16 );
+}
+
+TEST( UnitTest, ConvertToProgram_MemoryResource ) {
+	std::pmr::monotonic_buffer_resource arena;
+	auto program_result = stig::convert_to_program( test::expected_main, &arena );
+	ASSERT_TRUE( program_result ) << program_result.error();
+	auto& instrs = program_result->instrs;
+	ASSERT_EQ( instrs.size(), 6 );
+	EXPECT_EQ( instrs.at( 0x1146 ), test::expected_main.instructions[ 2 ] );
+	EXPECT_EQ( instrs.at( 0x1146 ).get_allocator().resource(), &arena );
+}
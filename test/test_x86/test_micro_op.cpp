@@ -0,0 +1,117 @@
+#include <gtest/gtest.h>
+
+#include <x86.hpp>
+
+#include "program_builder.hpp"
+
+namespace {
+
+	// A segment of scratch memory at 0x10000 to load from and store to.
+	stig::guest_memory scratch_memory() {
+		stig::guest_memory memory;
+		stig::guest_segment segment;
+		segment.address = 0x10000;
+		segment.size = 0x1000;
+		segment.flags = stig::segment_read | stig::segment_write;
+		segment.pages.resize( 1 );
+		memory.segments.push_back( std::move( segment ) );
+		return memory;
+	}
+
+}
+
+TEST( UnitTest, MicroOp_Lowering ) {
+	using stig::x86_mnemonic;
+	using stig::x86_register;
+	stig::x86_instruction load{ 0x1000, std::vector<uint8_t>( 7 ), x86_mnemonic::mov,
+								std::vector<stig::x86_operand>{ at( x86_register::rip, 0x20 ), x86_register::rax } };
+	auto op = stig::lower_micro_op( load );
+	EXPECT_EQ( op.opcode, stig::micro_opcode::mov_rm );
+	EXPECT_EQ( op.value, 0x1027 );
+	EXPECT_EQ( op.base.field, nullptr );
+	EXPECT_EQ( op.size, 8 );
+
+	stig::x86_instruction dword{ 0, std::vector<uint8_t>( 2 ), x86_mnemonic::mov,
+								 std::vector<stig::x86_operand>{ x86_register::rax, x86_register::edx } };
+	op = stig::lower_micro_op( dword );
+	EXPECT_EQ( op.opcode, stig::micro_opcode::mov_rr );
+	EXPECT_TRUE( op.dst.dword );
+
+	// Registers x86_cpu cannot hold, stack operations and rip-relative lea stay generic.
+	stig::x86_instruction r8{ 0, std::vector<uint8_t>( 3 ), x86_mnemonic::mov,
+							  std::vector<stig::x86_operand>{ x86_register::rax, x86_register::r8 } };
+	EXPECT_EQ( stig::lower_micro_op( r8 ).opcode, stig::micro_opcode::generic );
+	stig::x86_instruction push{ 0, std::vector<uint8_t>( 1 ), x86_mnemonic::push, std::vector<stig::x86_operand>{ x86_register::rax } };
+	EXPECT_EQ( stig::lower_micro_op( push ).opcode, stig::micro_opcode::generic );
+	stig::x86_instruction lea{ 0, std::vector<uint8_t>( 7 ), x86_mnemonic::lea,
+							   std::vector<stig::x86_operand>{ at( x86_register::rip, 0x20 ), x86_register::rdi } };
+	EXPECT_EQ( stig::lower_micro_op( lea ).opcode, stig::micro_opcode::generic );
+	stig::x86_instruction endbr64{ 0, std::vector<uint8_t>( 4 ), x86_mnemonic::endbr64, std::nullopt };
+	EXPECT_EQ( stig::lower_micro_op( endbr64 ).opcode, stig::micro_opcode::nop );
+}
+
+TEST( UnitTest, MicroOp_MatchesHandlers ) {
+	using stig::x86_mnemonic;
+	using stig::x86_register;
+	program_builder b;
+	b.add( 7, x86_mnemonic::mov, { stig::x86_immediate{ 5 }, x86_register::rdx } );
+	b.add( 7, x86_mnemonic::mov, { stig::x86_immediate{ 0x10000 }, x86_register::rsi } );
+	b.add( 4, x86_mnemonic::endbr64, {} );
+	uint64_t loop = b.address;
+	b.add( 4, x86_mnemonic::add, { stig::x86_immediate{ 3 }, x86_register::rax } );
+	b.add( 4, x86_mnemonic::mov, { x86_register::rax, at( x86_register::rsi, 0x10 ) } );
+	b.add( 4, x86_mnemonic::mov, { at( x86_register::rsi, 0x10 ), x86_register::r9 } );
+	b.add( 4, x86_mnemonic::lea, { at( x86_register::r9, 8 ), x86_register::rdi } );
+	b.add( 4, x86_mnemonic::and_, { stig::x86_immediate{ 0xff }, x86_register::rdi } );
+	b.add( 3, x86_mnemonic::xor_, { x86_register::r9, x86_register::rdi } );
+	b.add( 1, x86_mnemonic::push, { x86_register::rdi } );
+	b.add( 1, x86_mnemonic::pop, { x86_register::rdi } );
+	b.add( 2, x86_mnemonic::mov, { x86_register::edx, x86_register::ebp } );
+	b.add( 3, x86_mnemonic::cmp, { x86_register::rdx, x86_register::rsp } );
+	b.add( 3, x86_mnemonic::test, { x86_register::r9, x86_register::r9 } );
+	uint64_t never = b.address + 2 + 4 + 3 + 2 + 2;
+	b.add( 2, x86_mnemonic::je, { stig::x86_address{ never } } );
+	b.add( 4, x86_mnemonic::add, { stig::x86_immediate{ -1 }, x86_register::rdx } );
+	b.add( 3, x86_mnemonic::test, { x86_register::rdx, x86_register::rdx } );
+	b.add( 2, x86_mnemonic::jne, { stig::x86_address{ loop } } );
+	uint64_t exit = b.address + 2 + 1;
+	b.add( 2, x86_mnemonic::jmp, { stig::x86_address{ exit } } );
+	ASSERT_EQ( b.address, never );
+	b.add( 1, x86_mnemonic::hlt, {} );
+
+	auto prog = stig::convert_to_program( b.func );
+	ASSERT_TRUE( prog ) << prog.error();
+	auto table = stig::lower_program( prog.value() );
+	ASSERT_TRUE( table ) << table.error();
+	std::size_t lowered = std::count_if( table->steps.begin(), table->steps.end(), []( const stig::dispatch_step& step ) {
+		return step.op.opcode != stig::micro_opcode::generic;
+	} );
+	EXPECT_EQ( lowered, table->steps.size() - 3 );
+
+	// The same table with every micro-op forced back to its handler.
+	auto generic = table.value();
+	for ( auto& step : generic.steps ) {
+		step.op = stig::micro_op{};
+	}
+
+	stig::x86_vm micro{};
+	micro.memory = scratch_memory();
+	stig::x86_vm handlers{};
+	handlers.memory = scratch_memory();
+	auto micro_result = micro.run( table.value(), 0, exit );
+	ASSERT_TRUE( micro_result ) << micro_result.error();
+	auto handler_result = handlers.run( generic, 0, exit );
+	ASSERT_TRUE( handler_result ) << handler_result.error();
+
+	EXPECT_EQ( micro_result.value(), handler_result.value() );
+	EXPECT_EQ( micro.cpu.rax, 15 );
+	for ( auto field : { &stig::x86_cpu::rax, &stig::x86_cpu::rbp, &stig::x86_cpu::rdi, &stig::x86_cpu::rdx,
+						 &stig::x86_cpu::rip, &stig::x86_cpu::rsi, &stig::x86_cpu::rsp, &stig::x86_cpu::r9 } ) {
+		EXPECT_EQ( micro.cpu.*field, handlers.cpu.*field );
+	}
+	EXPECT_EQ( micro.cpu.zero_flag, handlers.cpu.zero_flag );
+	EXPECT_EQ( micro.cpu.sign_flag, handlers.cpu.sign_flag );
+	EXPECT_EQ( micro.cpu.carry_flag, handlers.cpu.carry_flag );
+	EXPECT_EQ( micro.cpu.overflow_flag, handlers.cpu.overflow_flag );
+	EXPECT_EQ( micro.memory.load( 0x10010, 8 ), handlers.memory.load( 0x10010, 8 ) );
+}
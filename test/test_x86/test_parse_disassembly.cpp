@@ -0,0 +1,67 @@
+#include <gtest/gtest.h>
+
+#include <x86.hpp>
+
+#include "test_constants.hpp"
+
+TEST( UnitTest, ParseDisassembly ) {
+	auto res = stig::parse_disassembly( "../test/main_disasm.txt", 1 );
+	ASSERT_TRUE( res ) << res.error();
+	auto& elf = res.value();
+	ASSERT_EQ( elf._init.size(), 1 );
+	EXPECT_EQ( elf._init[ 0 ].name, "_init" );
+	ASSERT_EQ( elf.plt.size(), 1 );
+	EXPECT_EQ( elf.plt[ 0 ].name, ".plt" );
+	ASSERT_EQ( elf.plt_got.size(), 1 );
+	EXPECT_EQ( elf.plt_got[ 0 ].name, "__cxa_finalize@plt" );
+	ASSERT_EQ( elf.text.size(), 7 );
+	EXPECT_EQ( elf.text[ 0 ].name, "_start" );
+	EXPECT_EQ( elf.text[ 6 ], test::expected_main );
+	ASSERT_EQ( elf.fini.size(), 1 );
+	EXPECT_EQ( elf.fini[ 0 ].name, "_fini" );
+}
+
+TEST( UnitTest, ParseDisassembly_Threads ) {
+	auto serial = stig::parse_disassembly( "../test/main_disasm.txt", 1 );
+	auto parallel = stig::parse_disassembly( "../test/main_disasm.txt", 4 );
+	ASSERT_TRUE( serial ) << serial.error();
+	ASSERT_TRUE( parallel ) << parallel.error();
+	EXPECT_EQ( serial->_init, parallel->_init );
+	EXPECT_EQ( serial->plt, parallel->plt );
+	EXPECT_EQ( serial->plt_got, parallel->plt_got );
+	EXPECT_EQ( serial->text, parallel->text );
+	EXPECT_EQ( serial->fini, parallel->fini );
+	EXPECT_EQ( serial->ranges, parallel->ranges );
+}
+
+TEST( UnitTest, ParseDisassembly_Ranges ) {
+	auto res = stig::parse_disassembly( "../test/main_disasm.txt", 1 );
+	ASSERT_TRUE( res ) << res.error();
+	auto& elf = res.value();
+	EXPECT_EQ( *elf.range( stig::elf_section::init ), ( stig::address_range{ 0x1000, 0x101b } ) );
+	EXPECT_EQ( *elf.range( stig::elf_section::text ), ( stig::address_range{ 0x1040, 0x1150 } ) );
+	EXPECT_EQ( *elf.range( stig::elf_section::fini ), ( stig::address_range{ 0x1150, 0x115d } ) );
+}
+
+TEST( UnitTest, FindFunction ) {
+	auto res = stig::parse_disassembly( "../test/main_disasm.txt", 1 );
+	ASSERT_TRUE( res ) << res.error();
+	auto* main_function = stig::find_function( res.value(), 0x1149 );
+	ASSERT_NE( main_function, nullptr );
+	EXPECT_EQ( main_function->name, "main" );
+	auto* plt_function = stig::find_function( res.value(), 0x1034 );
+	ASSERT_NE( plt_function, nullptr );
+	EXPECT_EQ( plt_function->name, "__cxa_finalize@plt" );
+	EXPECT_EQ( stig::find_function( res.value(), 0x101b ), nullptr );
+	EXPECT_EQ( stig::find_function( res.value(), 0x2000 ), nullptr );
+}
+
+TEST( UnitTest, SplitFunctions ) {
+	auto file = stig::map_file( "../test/main_disasm.txt" );
+	ASSERT_TRUE( file ) << file.error();
+	auto chunks = stig::split_functions( file->text() );
+	ASSERT_EQ( chunks.size(), 11 );
+	EXPECT_EQ( chunks[ 0 ].section, stig::elf_section::init );
+	EXPECT_EQ( chunks[ 10 ].section, stig::elf_section::fini );
+	EXPECT_TRUE( chunks[ 10 ].body.starts_with( "0000000000001150 <_fini>:" ) );
+}
@@ -0,0 +1,77 @@
+#include <gtest/gtest.h>
+
+#include <x86.hpp>
+
+TEST( UnitTest, ParseElf ) {
+	auto elf = stig::parse_elf( "../test/main" );
+	ASSERT_TRUE( elf ) << elf.error();
+	ASSERT_FALSE( elf->text.empty() );
+	EXPECT_EQ( elf->text.front().name, "_start" );
+	EXPECT_EQ( elf->_init.front().name, "_init" );
+	EXPECT_EQ( elf->fini.front().name, "_fini" );
+	EXPECT_EQ( elf->plt.front().name, ".plt" );
+	ASSERT_FALSE( elf->plt_got.empty() );
+	EXPECT_EQ( elf->plt_got.front().name, "__cxa_finalize@plt" );
+
+	auto main = std::find_if( elf->text.begin(), elf->text.end(), []( const stig::function& func ) { return func.name == "main"; } );
+	ASSERT_NE( main, elf->text.end() );
+	EXPECT_EQ( main->instructions.back().mnemonic, stig::x86_mnemonic::ret );
+
+	// Functions tile each section: every instruction starts where the previous one ended.
+	for ( auto section : { stig::elf_section::init, stig::elf_section::plt, stig::elf_section::plt_got,
+						   stig::elf_section::text, stig::elf_section::fini } ) {
+		const auto* range = elf->range( section );
+		uint64_t next = range->begin;
+		for ( const auto& func : *elf->functions( section ) ) {
+			for ( const auto& instruction : func.instructions ) {
+				EXPECT_EQ( instruction.address, next ) << func.name;
+				next = instruction.address + instruction.machine_bytes.size();
+			}
+		}
+		EXPECT_EQ( next, range->end );
+	}
+	EXPECT_EQ( stig::find_function( elf.value(), main->instructions.front().address ), &*main );
+}
+
+TEST( UnitTest, ParseElf_NotElf ) {
+	EXPECT_FALSE( stig::parse_elf( "../test/main_disasm.txt" ) );
+	EXPECT_FALSE( stig::parse_elf( std::vector<uint8_t>{ 0x7f, 'E', 'L', 'F' } ) );
+	EXPECT_FALSE( stig::parse_elf( "../test/does_not_exist" ) );
+}
+
+TEST( UnitTest, ParseElf_RecursiveDescent ) {
+	auto linear = stig::parse_elf( "../test/main" );
+	ASSERT_TRUE( linear ) << linear.error();
+	auto reachable = stig::parse_elf( "../test/main", stig::disassembly_mode::recursive_descent );
+	ASSERT_TRUE( reachable ) << reachable.error();
+
+	std::size_t linear_count = 0;
+	std::size_t reachable_count = 0;
+	for ( auto section : { stig::elf_section::init, stig::elf_section::plt, stig::elf_section::plt_got,
+						   stig::elf_section::text, stig::elf_section::fini } ) {
+		for ( const auto& func : *linear->functions( section ) ) {
+			linear_count += func.instructions.size();
+		}
+		// Everything reached is exactly what the sweep decoded at that address.
+		for ( const auto& func : *reachable->functions( section ) ) {
+			for ( const auto& instruction : func.instructions ) {
+				const auto* swept = stig::find_function( linear.value(), instruction.address );
+				ASSERT_NE( swept, nullptr );
+				EXPECT_EQ( swept->name, func.name );
+				auto it = std::find_if( swept->instructions.begin(), swept->instructions.end(), [ & ]( const stig::x86_instruction& other ) {
+					return other.address == instruction.address;
+				} );
+				ASSERT_NE( it, swept->instructions.end() );
+				EXPECT_EQ( *it, instruction );
+				++reachable_count;
+			}
+		}
+	}
+	EXPECT_LT( reachable_count, linear_count );
+
+	// _start ends in hlt; the alignment padding the sweep decodes after it is unreachable.
+	ASSERT_FALSE( reachable->text.empty() );
+	EXPECT_EQ( reachable->text.front().name, "_start" );
+	EXPECT_EQ( reachable->text.front().instructions.back().mnemonic, stig::x86_mnemonic::hlt );
+	EXPECT_NE( linear->text.front().instructions.back().mnemonic, stig::x86_mnemonic::hlt );
+}
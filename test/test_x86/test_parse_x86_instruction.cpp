@@ -298,3 +298,17 @@ TEST( UnitTest, ParseX86Instruction_Sub_Bytes ) {
 	auto res = stig::parse_x86_instruction( bytes );
 	ASSERT_TRUE( res ) << res.error();
 }
+
+TEST( UnitTest, ParseX86Instruction_Hlt ) {
+	std::string hlt_instruction = "1065:	f4                   	hlt";
+	stig::x86_instruction expected = {
+		0x1065,
+		std::vector<uint8_t>{ 0xf4 },
+		stig::x86_mnemonic::hlt,
+		std::nullopt
+	};
+	auto parse_result = stig::parse_x86_instruction( hlt_instruction );
+	ASSERT_TRUE( parse_result ) << parse_result.error();
+	auto& parsed_instruction = parse_result.value();
+	EXPECT_EQ( parsed_instruction.instruction, expected );
+}
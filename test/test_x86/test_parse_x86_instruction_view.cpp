@@ -0,0 +1,61 @@
+#include <gtest/gtest.h>
+
+#include <x86.hpp>
+
+TEST( UnitTest, ParseX86InstructionView ) {
+	std::string_view mov_instruction = "    1131:	89 7d fc             	mov    %edi,-0x4(%rbp)";
+	stig::x86_memory expected_mem = {
+		stig::x86_register::rbp,
+		std::nullopt,
+		std::nullopt,
+		-4
+	};
+	stig::x86_instruction expected = {
+		0x1131,
+		std::vector<uint8_t>{ 0x89, 0x7d, 0xfc },
+		stig::x86_mnemonic::mov,
+		std::vector<stig::x86_operand>{ stig::x86_register::edi, expected_mem }
+	};
+	auto parse_result = stig::parse_x86_instruction_view( mov_instruction );
+	ASSERT_TRUE( parse_result ) << parse_result.error();
+	EXPECT_EQ( parse_result.value(), expected );
+}
+
+TEST( UnitTest, ParseX86InstructionView_Call ) {
+	std::string_view call_instruction = "1014:	ff d0                	call   *%rax";
+	stig::x86_instruction expected = {
+		0x1014,
+		std::vector<uint8_t>{ 0xff, 0xd0 },
+		stig::x86_mnemonic::call,
+		std::vector<stig::x86_operand>{ stig::x86_register::rax }
+	};
+	auto parse_result = stig::parse_x86_instruction_view( call_instruction );
+	ASSERT_TRUE( parse_result ) << parse_result.error();
+	EXPECT_EQ( parse_result.value(), expected );
+}
+
+TEST( UnitTest, ParseX86InstructionView_UnknownMnemonic ) {
+	auto parse_result = stig::parse_x86_instruction_view( "1000:	c9                   	leave" );
+	EXPECT_FALSE( parse_result );
+}
+
+TEST( UnitTest, ParseX86InstructionView_MatchesParseX86Instruction ) {
+	std::ifstream file( "../test/main_disasm.txt" );
+	ASSERT_TRUE( file );
+	std::string line;
+	std::size_t count = 0;
+	while ( std::getline( file, line ) ) {
+		if ( line.find( ":\t" ) == std::string::npos ) {
+			continue;
+		}
+		std::string trimmed = line.substr( line.find_first_not_of( ' ' ) );
+		auto expected = stig::parse_x86_instruction( trimmed );
+		auto actual = stig::parse_x86_instruction_view( line );
+		ASSERT_EQ( expected.has_value(), actual.has_value() ) << line;
+		if ( expected ) {
+			EXPECT_EQ( expected.value().instruction, actual.value() ) << line;
+		}
+		++count;
+	}
+	EXPECT_GT( count, 0 );
+}
@@ -0,0 +1,56 @@
+#include <gtest/gtest.h>
+
+#include <x86.hpp>
+
+TEST( UnitTest, SymbolIndex ) {
+	auto elf = stig::open_elf_file( "../test/main" );
+	ASSERT_TRUE( elf ) << elf.error();
+	auto index = stig::build_symbol_index( elf.value() );
+	ASSERT_GT( index.size(), 0 );
+	for ( std::size_t i = 1; i < index.size(); ++i ) {
+		EXPECT_LT( index[ i - 1 ].address, index[ i ].address );
+		EXPECT_LE( index[ i - 1 ].end, index[ i ].address );
+	}
+
+	auto main = index.find( "main" );
+	ASSERT_TRUE( main );
+	EXPECT_EQ( main->name, "main" );
+	EXPECT_LT( main->address, main->end );
+	EXPECT_EQ( index.containing( main->address )->name, "main" );
+	EXPECT_EQ( index.containing( main->end - 1 )->name, "main" );
+	EXPECT_FALSE( index.find( "does_not_exist" ) );
+	EXPECT_FALSE( index.containing( 0 ) );
+
+	auto plt = index.find( "__cxa_finalize@plt" );
+	ASSERT_TRUE( plt );
+	EXPECT_EQ( index.containing( plt->address + 1 )->name, "__cxa_finalize@plt" );
+}
+
+TEST( UnitTest, SymbolIndex_MatchesParseElf ) {
+	auto elf = stig::open_elf_file( "../test/main" );
+	ASSERT_TRUE( elf ) << elf.error();
+	auto index = stig::build_symbol_index( elf.value() );
+	auto parsed = stig::parse_elf( elf.value() );
+	ASSERT_TRUE( parsed ) << parsed.error();
+
+	// The index owns its names, so it outlives the mapping. Every instruction of a
+	// named function symbolizes to that function, except alignment padding past a
+	// symbol's st_size, which objdump folds into the function before it.
+	elf = std::unexpected( "closed" );
+	for ( auto section : { stig::elf_section::init, stig::elf_section::plt_got, stig::elf_section::text, stig::elf_section::fini } ) {
+		for ( const auto& func : *parsed->functions( section ) ) {
+			auto entry = index.find( func.name );
+			ASSERT_TRUE( entry ) << func.name;
+			EXPECT_EQ( entry->address, func.instructions.front().address );
+			for ( const auto& instruction : func.instructions ) {
+				if ( instruction.address >= entry->end ) {
+					EXPECT_NE( instruction.mnemonic, stig::x86_mnemonic::ret ) << func.name;
+					continue;
+				}
+				auto symbol = index.containing( instruction.address );
+				ASSERT_TRUE( symbol ) << func.name;
+				EXPECT_EQ( symbol->name, func.name );
+			}
+		}
+	}
+}